@@ -0,0 +1,89 @@
+#include "Checkpointer.h"
+#include "checkUtil.h"
+#include <cstring>
+#include <filesystem>
+
+static bool sameState(TsetlinMachine &a, TsetlinMachine &b)
+{
+    bool isSame = (a.outputSize() == b.outputSize());
+    for (int j = 0; j < a.outputSize() && isSame; j++)
+    {
+        isSame &= (std::memcmp(a.state(j).data(), b.state(j).data(), a.state(j).tailOffset()) == 0);
+    }
+    return isSame;
+}
+
+// Change one literal block of every automata, as training would between two checkpoints.
+static void touch(TsetlinMachine &tm, int no)
+{
+    for (int j = 0; j < tm.outputSize(); j++)
+    {
+        ClauseArena &arena = tm.state(j);
+        arena.positiveLiterals(no)[0] = _mm512_add_epi32(arena.positiveLiterals(no)[0], _mm512_set1_epi32(1));
+        arena.refreshInclusion(no);
+        arena.markDirty(no, 0);
+    }
+}
+
+// Snapshots submitted faster than they are written collapse into one that still carries every change,
+// and a run resumed from the newest checkpoint continues numbering epochs from it.
+int main()
+{
+    checkReport report;
+    const string path = "asyncCheckpointCheck.ckpt";
+    Checkpointer::CheckpointArgs ckptArgs;
+    ckptArgs.path = path;
+    ckptArgs.maxChainLength = 16;
+
+    toyData     toy = makeToyData(60, 40, 3, 48);
+    TsetlinMachine::MachineArgs args = toyArgs(toy, 20);
+    args.seed = 48;
+    TsetlinMachine tm(args, {});
+    tm.load(toy.data, toy.response);
+    tm.train(1);
+
+    const int submitNum = 8;
+    {
+        Checkpointer                checkpointer(ckptArgs);
+        TsetlinMachine::Snapshot    base = tm.checkpoint(1);
+        base.tierTags = {string(32 << 20, 'x')};     // Bulky tag, the base write outlasts the submits below.
+        checkpointer.submit(std::move(base));
+        for (int k = 0; k < submitNum; k++)
+        {
+            touch(tm, k);
+            checkpointer.submit(tm.checkpoint(2 + k));
+        }
+        checkpointer.flush();
+        report.expect(checkpointer.writtenEpoch() == 1 + submitNum, "newest submitted epoch is written");
+    }
+    int deltaNum = 0;
+    while(std::filesystem::exists(path + ".delta" + std::to_string(deltaNum + 1))) deltaNum++;
+    report.expect(deltaNum < submitNum, "pending snapshots are replaced instead of queued");
+    {
+        std::shared_ptr<ModelFile>  base = Checkpointer::latest(path);
+        TsetlinMachine              resumed(base);
+        report.expect(Checkpointer::replay(path, *base, resumed) == 1 + submitNum, "replay reaches the newest epoch");
+        report.expect(sameState(resumed, tm), "merged dirty bits carry changes of replaced snapshots");
+    }
+
+    {
+        Checkpointer checkpointer(ckptArgs);
+        tm.train(4 + submitNum, checkpointer, 1 + submitNum);
+    }
+    Checkpointer::compact(path);
+    {
+        Checkpointer    checkpointer(ckptArgs);
+        TsetlinMachine  resumed(Checkpointer::latest(path));
+        const long      firstEpoch = Checkpointer::latest(path)->header().epoch;
+        report.expect(sameState(resumed, tm), "resumed machine starts from the checkpointed state");
+        resumed.load(toy.data, toy.response);
+        resumed.train(firstEpoch, checkpointer, firstEpoch);
+        report.expect(checkpointer.writtenEpoch() == -1 && sameState(resumed, tm), "a finished run trains no further");
+        resumed.train(firstEpoch + 2, checkpointer, firstEpoch);
+        report.expect(checkpointer.writtenEpoch() == firstEpoch + 2, "resumed run continues from the checkpointed epoch");
+        report.expect(Checkpointer::latest(path)->header().epoch == firstEpoch + 2, "newest checkpoint carries the resumed epoch");
+    }
+    Checkpointer::compact(path);
+    std::remove(path.c_str());
+    return report.exitCode();
+}
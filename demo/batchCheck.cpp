@@ -0,0 +1,29 @@
+#include "checkUtil.h"
+
+// Tiled multi-threaded prediction must equal one-by-one prediction, whatever the tiling.
+int main()
+{
+    checkReport report;
+    toyData     toy = makeToyData(301, 40, 3, 9);
+    TsetlinMachine tm(toyArgs(toy, 40), {});
+    tm.load(toy.data, toy.response);
+    tm.train(3);
+    vector<int> expected = tm.predict(std::span<const uint8_t>(toy.rows));
+    for(int tileSize : {1, 7, 256})
+    {
+        TsetlinMachine::BatchArgs args;
+        args.threadNum = 3;
+        args.tileSize = tileSize;
+        vector<int> classes(toy.data.size(), -1);
+        vector<int> scores(toy.data.size() * toy.outputSize, 0);
+        tm.predict(std::span<const uint8_t>(toy.rows), classes, scores, args);
+        bool isConsistent = true;
+        for (int i = 0; i < classes.size(); i++)
+        {
+            isConsistent &= (TsetlinMachine::argmax(&scores[i * toy.outputSize], toy.outputSize) == classes[i]);
+        }
+        report.expect(classes == expected, "tile size " + std::to_string(tileSize) + " equals row prediction");
+        report.expect(isConsistent, "tile size " + std::to_string(tileSize) + " classes follow scores");
+    }
+    return report.exitCode();
+}
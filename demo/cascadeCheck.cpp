@@ -0,0 +1,26 @@
+#include "TsetlinCascade.h"
+#include "checkUtil.h"
+#include <limits>
+
+// Extreme thresholds make the cascade answer exactly like one of its machines.
+int main()
+{
+    checkReport report;
+    toyData     toy = makeToyData(300, 24, 3, 7);
+    TsetlinMachine small(toyArgs(toy, 10), {}), large(toyArgs(toy, 40), {});
+    small.load(toy.data, toy.response);
+    large.load(toy.data, toy.response);
+    small.train(3);
+    large.train(3);
+    TsetlinMachine::model   smallModel = small.exportModel(), largeModel = large.exportModel();
+    TsetlinCascade          cascade(smallModel, largeModel);
+
+    cascade.setThreshold(std::numeric_limits<double>::infinity());
+    report.expect(cascade.loadAndPredict(toy.data) == large.loadAndPredict(toy.data), "infinite threshold answers like large machine");
+    report.expect(cascade.escalatedFraction() == 1, "every sample is escalated");
+    cascade.resetStats();
+    cascade.setThreshold(-1);
+    report.expect(cascade.loadAndPredict(toy.data) == small.loadAndPredict(toy.data), "negative threshold answers like small machine");
+    report.expect(cascade.escalatedFraction() == 0, "no sample is escalated");
+    return report.exitCode();
+}
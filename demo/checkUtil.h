@@ -0,0 +1,93 @@
+#pragma once
+#include "TsetlinMachine.h"
+#include <iostream>
+#include <random>
+#include <functional>
+#include <sys/wait.h>
+#include <unistd.h>
+using std::vector;
+using std::string;
+
+/// @brief Small deterministic dataset shared by the checks, class is a sum of a few columns.
+struct toyData
+{
+    int                     inputSize;
+    int                     outputSize;
+    vector<vector<int>>     data;       // ( sampleNum * inputSize ) of 0 and 1.
+    vector<vector<int>>     response;   // One-hot ( sampleNum * outputSize ).
+    vector<uint8_t>         rows;       // Same samples as one row-major buffer.
+    vector<uint8_t>         labels;
+};
+
+inline toyData makeToyData(int sampleNum, int inputSize, int outputSize, unsigned seed)
+{
+    std::mt19937    rng(seed);
+    toyData         result;
+    result.inputSize = inputSize;
+    result.outputSize = outputSize;
+    result.data.assign(sampleNum, vector<int>(inputSize, 0));
+    result.response.assign(sampleNum, vector<int>(outputSize, 0));
+    for (int i = 0; i < sampleNum; i++)
+    {
+        for (int k = 0; k < inputSize; k++)
+        {
+            result.data[i][k] = rng() & 1;
+            result.rows.push_back(result.data[i][k]);
+        }
+        int label = (result.data[i][0] + result.data[i][1] + result.data[i][2]) % outputSize;
+        result.response[i][label] = 1;
+        result.labels.push_back(label);
+    }
+    return result;
+}
+
+inline TsetlinMachine::MachineArgs toyArgs(const toyData &toy, int clausePerOutput)
+{
+    TsetlinMachine::MachineArgs args;
+    args.inputSize = toy.inputSize;
+    args.outputSize = toy.outputSize;
+    args.clausePerOutput = clausePerOutput;
+    args.T = 20;
+    args.sLow = 3.9;
+    args.sHigh = 3.9;
+    args.dropoutRatio = 0;
+    args.seed = 1;
+    return args;
+}
+
+/// @brief Clause of 2 * inputSize states where only the listed literals are included.
+inline vector<int> craftClause(int inputSize, vector<int> positive, vector<int> negative)
+{
+    vector<int> states(2 * inputSize, -10);
+    for (int k : positive) states[k] = 10;
+    for (int k : negative) states[inputSize + k] = 10;
+    return states;
+}
+
+/// @brief Print one line per expectation and count failures.
+struct checkReport
+{
+    int failed = 0;
+    void expect(bool passed, const string &what)
+    {
+        std::cout<<(passed? "PASS  " : "FAIL  ")<<what<<std::endl;
+        failed += !passed;
+    }
+    int exitCode()const {return failed == 0? 0 : 1;}
+};
+
+/// @brief Run a step in a child process, errors of this repo end the process instead of unwinding.
+/// @return Whether the step returned normally.
+inline bool runsCleanly(const std::function<void()> &step)
+{
+    std::cout.flush();
+    pid_t child = fork();
+    if(child == 0)
+    {
+        step();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
@@ -0,0 +1,68 @@
+#include "Checkpointer.h"
+#include "checkUtil.h"
+#include <cstring>
+#include <filesystem>
+
+// Literal blocks of two machines are identical.
+static bool sameState(TsetlinMachine &a, TsetlinMachine &b)
+{
+    bool isSame = (a.outputSize() == b.outputSize());
+    for (int j = 0; j < a.outputSize() && isSame; j++)
+    {
+        isSame &= (std::memcmp(a.state(j).data(), b.state(j).data(), a.state(j).tailOffset()) == 0);
+    }
+    return isSame;
+}
+
+// Base plus replayed deltas must rebuild the trained state, and compaction must not change it.
+int main()
+{
+    checkReport report;
+    toyData     toy = makeToyData(60, 40, 3, 11);
+    const string path = "checkpointCheck.ckpt";
+    Checkpointer::CheckpointArgs args;
+    args.path = path;
+    args.interval = 1;
+    args.maxChainLength = 3;
+    TsetlinMachine tm(toyArgs(toy, 20), {});
+    tm.load(toy.data, toy.response);
+    {
+        Checkpointer checkpointer(args);
+        tm.train(2, checkpointer);
+        report.expect(checkpointer.writtenEpoch() == 2, "last epoch is written");
+    }
+    {
+        Checkpointer checkpointer(args);
+        checkpointer.submit(tm.checkpoint(3));      // A new checkpointer starts from a base.
+        checkpointer.flush();
+        for (int j = 0; j < tm.outputSize(); j++)   // Sparse change since the base.
+        {
+            ClauseArena &arena = tm.state(j);
+            arena.positiveLiterals(0)[0] = _mm512_add_epi32(arena.positiveLiterals(0)[0], _mm512_set1_epi32(1));
+            arena.refreshInclusion(0);
+            arena.markDirty(0, 0);
+        }
+        checkpointer.submit(tm.checkpoint(4));
+        checkpointer.flush();
+        report.expect(std::filesystem::exists(path + ".delta1"), "sparse change is written as a delta");
+        report.expect(checkpointer.writtenEpoch() == 4, "delta epoch is written");
+    }
+    {
+        std::shared_ptr<ModelFile>  base = Checkpointer::latest(path);
+        TsetlinMachine              resumed(base);
+        long                        epoch = Checkpointer::replay(path, *base, resumed);
+        report.expect(epoch == 4, "replay reaches the newest delta");
+        report.expect(sameState(resumed, tm), "replayed state equals trained state");
+        report.expect(resumed.loadAndPredict(toy.data) == tm.loadAndPredict(toy.data), "replayed machine predicts like trained one");
+    }
+    Checkpointer::compact(path);
+    {
+        std::shared_ptr<ModelFile>  base = Checkpointer::latest(path);
+        TsetlinMachine              compacted(base);
+        report.expect(!std::filesystem::exists(path + ".delta1"), "compaction removes the chain");
+        report.expect(base->header().epoch == 4, "compacted base carries the newest epoch");
+        report.expect(sameState(compacted, tm), "compacted state equals trained state");
+    }
+    std::remove(path.c_str());
+    return report.exitCode();
+}
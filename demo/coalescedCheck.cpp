@@ -0,0 +1,49 @@
+#include "CoalescedTsetlinMachine.h"
+#include "checkUtil.h"
+
+// A shared pool with a clause count off the 16 lane grid learns a separable rule and keeps its padding silent.
+int main()
+{
+    checkReport report;
+    const int   inputSize = 16, outputSize = 3, clauseNum = 37, paddedNum = 48;
+    std::mt19937        rng(28);
+    vector<vector<int>> data(400, vector<int>(inputSize, 0));
+    vector<vector<int>> response(400, vector<int>(outputSize, 0));
+    for (int i = 0; i < data.size(); i++)
+    {
+        for (int k = 0; k < inputSize; k++) data[i][k] = rng() & 1;
+        response[i][data[i][0]? 0 : (data[i][1]? 1 : 2)] = 1;     // x0, else x1, else neither.
+    }
+
+    CoalescedTsetlinMachine::MachineArgs args;
+    args.inputSize = inputSize;
+    args.outputSize = outputSize;
+    args.clauseNum = clauseNum;
+    args.T = 15;
+    args.sLow = 3.9;
+    args.sHigh = 3.9;
+    args.dropoutRatio = 0;
+    args.seed = 28;
+    CoalescedTsetlinMachine tm(args, {});
+    tm.load(data, response);
+    tm.train(30);
+
+    vector<vector<int>> predicted = tm.loadAndPredict(data);
+    int correct = 0;
+    for (int i = 0; i < data.size(); i++) correct += (predicted[i] == response[i]);
+    report.expect(correct >= 0.9 * data.size(), "separable rule is learned by the shared pool");
+
+    CoalescedTsetlinMachine::model saved = tm.exportModel();
+    const vector<int> &padded = tm.paddedWeights();
+    bool rowsMatch = (saved.weights.size() == outputSize) && (padded.size() == outputSize * paddedNum);
+    bool paddingZero = rowsMatch;
+    for (int output = 0; output < outputSize && rowsMatch; output++)
+    {
+        const int *row = padded.data() + output * paddedNum;
+        rowsMatch &= (saved.weights[output] == vector<int>(row, row + clauseNum));
+        for (int i = clauseNum; i < paddedNum; i++) paddingZero &= (row[i] == 0);
+    }
+    report.expect(rowsMatch, "exported weight rows hold one weight per pool clause");
+    report.expect(paddingZero, "padded clauses keep zero weight after training");
+    return report.exitCode();
+}
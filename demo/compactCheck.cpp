@@ -0,0 +1,29 @@
+#include "checkUtil.h"
+
+// Compaction drops clauses that never fire or cancel out, merges duplicates and keeps only used columns.
+int main()
+{
+    checkReport report;
+    const int   inputSize = 12;
+    toyData     toy = makeToyData(200, inputSize, 2, 3);
+    TsetlinMachine::model crafted;
+    crafted.modelArgs = toyArgs(toy, 4);
+    crafted.automatas.resize(2);
+    vector<int> empty = craftClause(inputSize, {}, {});
+    // Output 0 : x3 twice merges into one clause, x5 & ~x5 never fires.
+    crafted.automatas[0].positiveClauses = {craftClause(inputSize, {3}, {}), craftClause(inputSize, {3}, {}),
+                                            craftClause(inputSize, {5}, {5}), empty};
+    crafted.automatas[0].negativeClauses = {empty, empty, empty, empty};
+    // Output 1 : x7 in both polarities cancels, ~x9 is kept.
+    crafted.automatas[1].positiveClauses = {craftClause(inputSize, {7}, {}), craftClause(inputSize, {}, {9}), empty, empty};
+    crafted.automatas[1].negativeClauses = {craftClause(inputSize, {7}, {}), empty, empty, empty};
+    TsetlinMachine tm(crafted);
+
+    report.expect(runsCleanly([&]{tm.compact();}) == false, "compaction without loaded data is rejected");
+    tm.load(toy.data, toy.response);
+    CompactMachine compact = tm.compact();
+    report.expect(compact.inputRemap() == vector<int>({3, 9}), "only columns 3 and 9 are kept");
+    report.expect(compact.clauseNum() == 3, "x3, ~x9 and the empty clause remain");
+    report.expect(compact.loadAndPredict(toy.data) == tm.loadAndPredict(toy.data), "compact prediction equals full prediction");
+    return report.exitCode();
+}
@@ -0,0 +1,61 @@
+#include "checkUtil.h"
+#include <thread>
+#include <atomic>
+
+// Many threads predicting on one const machine at once get exactly the serial answers.
+int main()
+{
+    checkReport report;
+    toyData     toy = makeToyData(400, 50, 4, 45);
+    TsetlinMachine::MachineArgs args = toyArgs(toy, 30);
+    args.seed = 45;
+    TsetlinMachine trained(args, {});
+    trained.load(toy.data, toy.response);
+    trained.train(3);
+    const TsetlinMachine &tm = trained;
+
+    const vector<vector<int>>   serialOneHot = tm.loadAndPredict(toy.data);
+    const vector<int>           serialRows = tm.predict(std::span<const uint8_t>(toy.rows));
+    TsetlinMachine::PackedSet   packed = tm.packSet(toy.data, toy.response);
+    const double                serialAccuracy = tm.evaluate(packed);
+    TsetlinMachine::EarlyExitArgs exitArgs;
+    exitArgs.chunkSize = 4;
+    const vector<vector<int>>   serialEarly = tm.loadAndPredict(toy.data, exitArgs);
+
+    const int           threadNum = 8, rounds = 20;
+    std::atomic<int>    mismatches(0);
+    vector<std::thread> workers;
+    for (int t = 0; t < threadNum; t++)
+    {
+        workers.emplace_back([&, t]
+        {
+            vector<vector<int>> data = toy.data;        // Inputs are per caller, the machine is shared.
+            for (int r = 0; r < rounds; r++)
+            {
+                switch((t + r) % 4)
+                {
+                case 0: mismatches += (tm.loadAndPredict(data) != serialOneHot); break;
+                case 1: mismatches += (tm.predict(std::span<const uint8_t>(toy.rows)) != serialRows); break;
+                case 2: mismatches += (tm.evaluate(packed) != serialAccuracy); break;
+                case 3: mismatches += (tm.loadAndPredict(data, exitArgs) != serialEarly); break;
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) worker.join();
+    report.expect(mismatches == 0, "concurrent const predictions equal serial predictions");
+
+    TsetlinMachine::model after = trained.exportModel();
+    TsetlinMachine        reference(args, {});
+    reference.load(toy.data, toy.response);
+    reference.train(3);
+    TsetlinMachine::model expected = reference.exportModel();
+    bool isSame = true;
+    for (int j = 0; j < toy.outputSize; j++)
+    {
+        isSame &= (after.automatas[j].positiveClauses == expected.automatas[j].positiveClauses) &&
+                  (after.automatas[j].negativeClauses == expected.automatas[j].negativeClauses);
+    }
+    report.expect(isSame, "prediction leaves clause states untouched");
+    return report.exitCode();
+}
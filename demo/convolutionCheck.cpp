@@ -0,0 +1,71 @@
+#include "ConvolutionalTsetlinMachine.h"
+#include "checkUtil.h"
+
+// One-hot nucleotides of a random sequence, the motif ACG is placed at 'position' or nowhere if negative.
+static vector<int> makeSequence(std::mt19937 &rng, int length, int position, bool isRandom = true)
+{
+    vector<int> symbols(length, 3);
+    for (int k = 0; k < length && isRandom; k++)
+    {
+        symbols[k] = rng() % 4;
+        while(k >= 2 && symbols[k-2] == 0 && symbols[k-1] == 1 && symbols[k] == 2) symbols[k] = rng() % 4;
+    }
+    if(position >= 0)
+    {
+        symbols[position] = 0;
+        symbols[position + 1] = 1;
+        symbols[position + 2] = 2;
+    }
+    vector<int> bits(length * 4, 0);
+    for (int k = 0; k < length; k++) bits[k * 4 + symbols[k]] = 1;
+    return bits;
+}
+
+// A motif at varying positions is covered by window clauses, far fewer than one clause per position.
+int main()
+{
+    checkReport report;
+    const int   length = 16, windowSize = 3;
+    std::mt19937        rng(35);
+    vector<vector<int>> data, response;
+    for (int i = 0; i < 1200; i++)
+    {
+        bool hasMotif = i % 2;
+        data.push_back(makeSequence(rng, length, hasMotif? (int)(rng() % (length - 2)) : -1));
+        response.push_back({!hasMotif, hasMotif});
+    }
+
+    ConvolutionalTsetlinMachine::MachineArgs args;
+    args.sequenceLength = length;
+    args.symbolWidth = 4;
+    args.windowSize = windowSize;
+    args.outputSize = 2;
+    args.clausePerOutput = 12;
+    args.T = 8;
+    args.sLow = 10;
+    args.sHigh = 10;
+    args.dropoutRatio = 0;
+    args.seed = 35;
+    ConvolutionalTsetlinMachine tm(args, {});
+    tm.load(data, response);
+    tm.train(100);
+    report.expect(tm.patchSize() == windowSize * 4, "a window covers windowSize symbols");
+
+    vector<vector<int>> probe;
+    for (int position = 0; position <= length - windowSize; position++)
+    {
+        probe.push_back(makeSequence(rng, length, position, false));   // Only the motif position differs.
+    }
+    vector<vector<int>> predicted = tm.loadAndPredict(probe);
+    int found = 0;
+    for (auto &row : predicted) found += (row[1] == 1);
+    report.expect(found == probe.size(), "motif is found at every position with 12 clauses per output");
+
+    vector<vector<int>> absent;
+    for (int i = 0; i < 50; i++) absent.push_back(makeSequence(rng, length, -1));
+    predicted = tm.loadAndPredict(absent);
+    int quiet = 0;
+    for (auto &row : predicted) quiet += (row[0] == 1);
+    report.expect(quiet >= 40, "sequences without the motif are rejected");
+    return report.exitCode();
+}
@@ -0,0 +1,15 @@
+#include "checkUtil.h"
+
+// Without budget or deadline, early exit stops only when the class can no longer change.
+int main()
+{
+    checkReport report;
+    toyData     toy = makeToyData(300, 40, 3, 6);
+    TsetlinMachine tm(toyArgs(toy, 40), {});
+    tm.load(toy.data, toy.response);
+    tm.train(5);
+    TsetlinMachine::EarlyExitArgs args;
+    args.chunkSize = 4;
+    report.expect(tm.loadAndPredict(toy.data, args) == tm.loadAndPredict(toy.data), "unbounded early exit equals full vote");
+    return report.exitCode();
+}
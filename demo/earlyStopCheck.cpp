@@ -0,0 +1,19 @@
+#include "checkUtil.h"
+
+// Early stopping must leave the machine in the state whose accuracy it reports.
+int main()
+{
+    checkReport report;
+    toyData     train = makeToyData(300, 24, 3, 1);
+    toyData     valid = makeToyData(100, 24, 3, 2);
+    TsetlinMachine tm(toyArgs(train, 40), {});
+    tm.load(train.data, train.response);
+    TsetlinMachine::PackedSet   validation = tm.packSet(valid.data, valid.response);
+    TsetlinMachine::StopArgs    stopArgs;
+    stopArgs.evalInterval = 1;
+    stopArgs.patience = 2;
+    double best = tm.train(10, validation, stopArgs);
+    report.expect(best >= 0 && best <= 1, "best accuracy is a valid ratio");
+    report.expect(tm.evaluate(validation) == best, "machine is restored to its best state");
+    return report.exitCode();
+}
@@ -0,0 +1,40 @@
+#include "TsetlinEnsemble.h"
+#include "checkUtil.h"
+
+// Ensemble decides on summed member votes by the same rule as a single machine.
+int main()
+{
+    checkReport report;
+    const int   allNegative[3] = {-5, -1, -3};
+    const int   tied[3] = {2, 4, 4};
+    report.expect(TsetlinMachine::argmax(allNegative, 3) == 0, "class 0 wins when no sum is positive");
+    report.expect(TsetlinMachine::argmax(tied, 3) == 1, "ties go to the lower index");
+
+    toyData                     toy = makeToyData(300, 24, 3, 4);
+    TsetlinEnsemble::EnsembleArgs args;
+    args.machineArgs = toyArgs(toy, 20);
+    args.memberNum = 3;
+    args.threadNum = 2;
+    args.seed = 1;
+    TsetlinEnsemble::EnsembleArgs empty = args, blind = args;
+    empty.memberNum = 0;
+    blind.featureRatio = 0;
+    report.expect(!runsCleanly([&]{TsetlinEnsemble rejected(empty, {});}), "ensemble without members is rejected");
+    report.expect(!runsCleanly([&]{TsetlinEnsemble rejected(blind, {});}), "featureRatio outside (0, 1] is rejected");
+    TsetlinEnsemble ensemble(args, {});
+    ensemble.load(toy.data, toy.response);
+    ensemble.train(3);
+
+    TsetlinMachine      packer(args.machineArgs, {});
+    PackedData          mdata = packer.packData(toy.data);
+    vector<int>         scores = ensemble.score(mdata);
+    vector<vector<int>> predicted = ensemble.loadAndPredict(toy.data);
+    bool isSame = true;
+    for (int i = 0; i < toy.data.size(); i++)
+    {
+        int winner = TsetlinMachine::argmax(&scores[(size_t)i * toy.outputSize], toy.outputSize);
+        isSame &= (predicted[i][winner] == 1);
+    }
+    report.expect(isSame, "ensemble prediction is argmax of summed scores");
+    return report.exitCode();
+}
@@ -0,0 +1,62 @@
+#include "MultiTsetlinTrainer.h"
+#include "checkUtil.h"
+
+static TsetlinMachine::MachineArgs makeConfig(int clausePerOutput, int T, uint64_t seed)
+{
+    TsetlinMachine::MachineArgs args;
+    args.inputSize = 30;
+    args.outputSize = 3;
+    args.clausePerOutput = clausePerOutput;
+    args.T = T;
+    args.sLow = 3.9;
+    args.sHigh = 3.9;
+    args.dropoutRatio = 0;
+    args.shuffle = false;       // Same visiting order alone and in lockstep.
+    args.seed = seed;
+    return args;
+}
+
+// Streaming samples through all configurations leaves each one exactly as training it alone.
+int main()
+{
+    checkReport report;
+    std::mt19937        rng(34);
+    vector<vector<int>> data(300, vector<int>(30, 0));
+    vector<vector<int>> response(300, vector<int>(3, 0));
+    for (int i = 0; i < data.size(); i++)
+    {
+        for (int k = 0; k < 30; k++) data[i][k] = rng() & 1;
+        response[i][data[i][3] + data[i][4] + data[i][5] > 1? (data[i][6]? 1 : 2) : 0] = 1;
+    }
+
+    MultiTsetlinTrainer::TrainerArgs trainerArgs;
+    trainerArgs.configs = {makeConfig(10, 10, 101), makeConfig(24, 15, 202), makeConfig(16, 5, 303)};
+    trainerArgs.threadNum = 2;
+    MultiTsetlinTrainer trainer(trainerArgs, {});
+    trainer.load(data, response);
+    trainer.train(4);
+
+    vector<TsetlinMachine::model> lockstep = trainer.exportModels();
+    for (int c = 0; c < trainerArgs.configs.size(); c++)
+    {
+        TsetlinMachine alone(trainerArgs.configs[c], {});
+        alone.load(data, response);
+        alone.train(4);
+        TsetlinMachine::model single = alone.exportModel();
+        bool isSame = (single.automatas.size() == lockstep[c].automatas.size());
+        for (int j = 0; j < single.automatas.size() && isSame; j++)
+        {
+            isSame &= (single.automatas[j].positiveClauses == lockstep[c].automatas[j].positiveClauses) &&
+                      (single.automatas[j].negativeClauses == lockstep[c].automatas[j].negativeClauses);
+        }
+        report.expect(isSame, "config " + std::to_string(c) + " has the states it reaches alone");
+    }
+
+    MultiTsetlinTrainer::TrainerArgs empty, remapped = trainerArgs;
+    remapped.configs[1].inputRemap.assign(30, 0);
+    remapped.configs[1].originalInputSize = 60;
+    for (int k = 0; k < 30; k++) remapped.configs[1].inputRemap[k] = 2 * k;
+    report.expect(!runsCleanly([&]{MultiTsetlinTrainer rejected(empty, {});}), "empty configuration list is rejected");
+    report.expect(!runsCleanly([&]{MultiTsetlinTrainer rejected(remapped, {});}), "configurations with different remaps are rejected");
+    return report.exitCode();
+}
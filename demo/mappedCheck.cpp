@@ -0,0 +1,67 @@
+#include "MappedDataset.h"
+#include "checkUtil.h"
+#include <fstream>
+#include <cstddef>
+
+// Copy of a packed dataset file named path + suffix, with 'size' bytes at 'offset' overwritten.
+static string damage(const string &path, const string &suffix, size_t offset, const void *bytes, size_t size)
+{
+    const string    damaged = path + suffix;
+    std::ifstream   source(path, std::ios::binary);
+    string          content((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+    content.replace(offset, size, (const char*)bytes, size);
+    std::ofstream(damaged, std::ios::binary | std::ios::trunc)<<content;
+    return damaged;
+}
+
+// Rows read back from a packed dataset file carry the same literals as in-memory packing.
+int main()
+{
+    checkReport report;
+    toyData     toy = makeToyData(200, 70, 3, 8);
+    toy.data[0][5] = -1;        // Negative values are false literals in every path.
+    toy.rows[5] = 0;
+    const string path = "mappedCheck.tmpk";
+    MappedDataset::write(path, toy.data, toy.response);
+    {
+        MappedDataset               file(path);
+        std::span<const uint64_t>   rows = file.rows(0, file.size());
+        std::span<const uint8_t>    labels = file.labels(0, file.size());
+        bool isSame = (file.size() == toy.data.size()) && (file.inputSize() == toy.inputSize);
+        for (size_t i = 0; i < file.size() && isSame; i++)
+        {
+            for (int k = 0; k < toy.inputSize; k++)
+            {
+                int bit = (rows[i * file.wordsPerSample() + k / 64] >> (k % 64)) & 1;
+                isSame &= (bit == toy.rows[i * toy.inputSize + k]);
+            }
+            isSame &= (labels[i] == toy.labels[i]);
+        }
+        report.expect(isSame, "mapped rows and labels equal the source");
+
+        TsetlinMachine tm(toyArgs(toy, 20), {});
+        tm.load(toy.data, toy.response);
+        tm.train(2);
+        TsetlinMachine::PackedSet fromBytes = tm.packSet(std::span<const uint8_t>(toy.rows), std::span<const uint8_t>(toy.labels));
+        TsetlinMachine::PackedSet fromInts = tm.packSet(toy.data, toy.response);
+        report.expect(tm.evaluate(fromBytes) == tm.evaluate(fromInts), "byte and int packing agree");
+    }
+
+    vector<vector<int>> wide(toy.data.size(), vector<int>(257, 0));
+    for (size_t i = 0; i < wide.size(); i++) wide[i][i % 257] = 1;
+    report.expect(!runsCleanly([&]{MappedDataset::write(path + ".wide", toy.data, wide);}), "more than 256 outputs are rejected on write");
+
+    MappedDataset::Header   header;
+    std::ifstream(path, std::ios::binary).read((char*)&header, sizeof(header));
+    uint64_t    shortLabel = 8, oddRow = header.rowOffset - 8;   // Still inside the file, only misaligned.
+    uint8_t     badLabel = toy.outputSize;
+    const string inHeader = damage(path, ".header", offsetof(MappedDataset::Header, labelOffset), &shortLabel, sizeof(shortLabel));
+    const string unaligned = damage(path, ".unaligned", offsetof(MappedDataset::Header, rowOffset), &oddRow, sizeof(oddRow));
+    const string outOfRange = damage(path, ".label", header.labelOffset + 3, &badLabel, sizeof(badLabel));
+    report.expect(runsCleanly([&]{MappedDataset file(path);}), "intact file opens");
+    report.expect(!runsCleanly([&]{MappedDataset file(inHeader);}), "labels overlapping the header are rejected");
+    report.expect(!runsCleanly([&]{MappedDataset file(unaligned);}), "unaligned rows are rejected");
+    report.expect(!runsCleanly([&]{MappedDataset file(outOfRange);}), "labels outside outputSize are rejected");
+    for (const string &file : {path, path + ".wide", inHeader, unaligned, outOfRange}) std::remove(file.c_str());
+    return report.exitCode();
+}
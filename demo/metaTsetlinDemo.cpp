@@ -1,4 +1,6 @@
 #include "TsetlinMachine.h"
+#include "PackedDataset.h"
+#include "NumaTopology.h"
 #include "io.h"
 #include "nucleotides.h"
 #include <climits>
@@ -14,19 +16,19 @@ struct modelAndArgs
     double                  value;  // Necessary in RSA interface protocol
     int                     clauseNum;
     int                     T;
-    TsetlinMachine::model   model;
+    TsetlinMachine::SnapshotHandle  snapshot;   // Shared by every copy the optimizers make.
     modelAndArgs()
     {
         value = -(__DBL_MAX__);
     }
     modelAndArgs(   double valueIn,
                     int TIn, int clauseN,
-                    TsetlinMachine::model modelIn)
+                    TsetlinMachine::SnapshotHandle snapshotIn)
     {
         value = valueIn;
         clauseNum = clauseN;
         T = TIn;
-        model = modelIn;
+        snapshot = snapshotIn;
     }
 };
 
@@ -38,10 +40,13 @@ struct tsetlinArgs
     int epochNum;
     double sLow;
     double sHigh;
-    dataset data;
+    vector<string> tierTags;
+    vector<PackedDataset::Handle> packed;   // Packed once and shared by every proposal, one per NUMA node.
     vector<int> vars;   // clausePerOutput and T become the variable.
+    TsetlinMachine::SnapshotHandle warmSnapshot;  // Each optimizer warm starts from its previous proposal.
+    bool numaAware = false;             // Pin each optimizer thread to a node before it copies data.
     tsetlinArgs(){}
-    tsetlinArgs( double dor, int is, int os,int epo, double sl, double sh, dataset indata)
+    tsetlinArgs( double dor, int is, int os,int epo, double sl, double sh, vector<string> tags)
     {
         epochNum = epo;
         dropoutRatio = dor;
@@ -49,7 +54,7 @@ struct tsetlinArgs
         outputSize = os;
         sLow = sl;
         sHigh = sh;
-        data = indata;
+        tierTags = tags;
         vars.resize(2,0);
     }
 };
@@ -57,14 +62,13 @@ struct tsetlinArgs
 
 modelAndArgs siRNAdemo(tsetlinArgs &funcArgs)
 {
-    vector<vector<int>> train_seqs = funcArgs.data.trainData;
-    vector<vector<int>> train_scores= funcArgs.data.trainResponse;
-    vector<vector<int>> test_seqs = funcArgs.data.testData;
-    vector<vector<int>> test_scores= funcArgs.data.testResponse;
-    int test_data_size = test_seqs.size();
-
+    static thread_local int node = -1;      // Optimizers spawn fresh threads every iteration, each is pinned on its first proposal.
+    if(node < 0)
+    {
+        node = funcArgs.numaAware? NumaTopology::instance().pinNextThread() : 0;
+    }
+    const PackedDataset::Handle &packed = funcArgs.packed[node % funcArgs.packed.size()];
 
-    TsetlinMachine::model       bestModel;
     double                      bestPrecision = 0;
     TsetlinMachine::MachineArgs mArgs;
     mArgs.clausePerOutput = funcArgs.vars[0];
@@ -75,34 +79,17 @@ modelAndArgs siRNAdemo(tsetlinArgs &funcArgs)
     mArgs.sLow = funcArgs.sLow;
     mArgs.sHigh = funcArgs.sHigh;
     
-    TsetlinMachine tm(mArgs,funcArgs.data.tierTags);
-    tm.load(train_seqs,train_scores);
-    for (int i = 0; i < funcArgs.epochNum; i++)
-    {
-        tm.train(1);
-        vector<vector<int>> predict = tm.loadAndPredict(test_seqs);
-        int totalCorrect = 0;
-        for (int sample = 0; sample < predict.size(); sample++)
-        {
-            bool correct = true;
-            for (int digit = 0; digit < predict[0].size(); digit++)
-            {
-                if(predict[sample][digit] != test_scores[sample][digit])
-                {
-                    correct = false;
-                    break;
-                }
-            }
-            totalCorrect += correct;
-        }
-        double thisPrecision = totalCorrect / (double)test_data_size;
-        if(thisPrecision>bestPrecision)
-        {
-            bestPrecision = thisPrecision;
-            bestModel = tm.exportModel();
-        }
-    }
-    modelAndArgs result(bestPrecision,mArgs.T,mArgs.clausePerOutput,bestModel);
+    TsetlinMachine tm = funcArgs.warmSnapshot?  TsetlinMachine(*funcArgs.warmSnapshot, mArgs) :
+                                                TsetlinMachine(mArgs, funcArgs.tierTags);
+    tm.load(packed);
+    const TsetlinMachine::PackedSet &validation = packed->validation();
+    TsetlinMachine::StopArgs    stopArgs;
+    stopArgs.evalInterval = 1;
+    stopArgs.patience = 10;
+    stopArgs.minDelta = 0;
+    bestPrecision = tm.train(funcArgs.epochNum, validation, stopArgs);
+    funcArgs.warmSnapshot = tm.share();     // Machine is restored to its best state.
+    modelAndArgs result(bestPrecision,mArgs.T,mArgs.clausePerOutput,funcArgs.warmSnapshot);
     return result;
 }
 
@@ -119,7 +106,7 @@ int main(int argc, char const *argv[])
     ////////////// Tsetlin Machine parameters initialization///////////////
     int             responseClassNum = 2;
     int             outputSize= responseClassNum;
-    int             epochNum = 50;
+    int             epochNum = 50;     // Warm started proposals usually stop much earlier.
     double          dropoutRatio = 0.5;
     double          trainRatio = 0.9;
     vector<string>  seqs = readcsvline<string>("../data/siRNA/e2sall/e2sIncSeqs.csv");
@@ -127,7 +114,19 @@ int main(int argc, char const *argv[])
 
     dataset         data = transformer.parseAndDivide(seqs,res,trainRatio,responseClassNum);
     int             inputSize= data.trainData[0].size();
-    tsetlinArgs     funcArgs(dropoutRatio,inputSize,outputSize,epochNum,2.0f,200.0f,data);
+    tsetlinArgs     funcArgs(dropoutRatio,inputSize,outputSize,epochNum,2.0f,200.0f,data.tierTags);
+    funcArgs.numaAware = true;
+    if(NumaTopology::instance().nodeNum() == 1)     // Nothing to gain from a copy.
+    {
+        funcArgs.packed.push_back(PackedDataset::share(PackedDataset(data)));
+    }
+    else
+    {
+        for(auto &replica : NumaTopology::instance().replicate(PackedDataset(data)))
+        {
+            funcArgs.packed.push_back(PackedDataset::share(std::move(replica)));
+        }
+    }
     ////////////// Tsetlin Machine parameters initialization ///////////////
 
 
@@ -194,7 +193,8 @@ int main(int argc, char const *argv[])
                                     "NucPattern strength",
                                     "GC Content Pattern",
                                     "GCpattern strength"};
-    transformer.deparseAndOutput(result[bestIdx].model,result[bestIdx].value,deparseHeaders,"./");
+    TsetlinMachine::model bestTM = TsetlinMachine::toModel(*result[bestIdx].snapshot);  // Unpacked once, for output only.
+    transformer.deparseAndOutput(bestTM,result[bestIdx].value,deparseHeaders,"./");
     /////////////////// Result output //////////////////////////
     return 0;
 }
\ No newline at end of file
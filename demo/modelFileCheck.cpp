@@ -0,0 +1,52 @@
+#include "ModelFile.h"
+#include "checkUtil.h"
+#include <fstream>
+
+// A written model file maps back to an identical machine and a damaged one is rejected.
+int main()
+{
+    checkReport report;
+    toyData     toy = makeToyData(300, 40, 3, 10);
+    TsetlinMachine tm(toyArgs(toy, 40), {});
+    tm.load(toy.data, toy.response);
+    tm.train(3);
+    const string path = "modelFileCheck.tmmd", damaged = "modelFileCheck.bad.tmmd";
+    ModelFile::write(path, tm);
+    {
+        TsetlinMachine mapped(ModelFile::open(path));
+        report.expect(mapped.loadAndPredict(toy.data) == tm.loadAndPredict(toy.data), "mapped machine predicts like the original");
+        report.expect(mapped.tierTags() == tm.tierTags() && mapped.args() == tm.args(), "args and tags round trip");
+    }
+    {
+        std::ifstream       input(path, std::ios::binary);
+        vector<char>        bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        bytes[bytes.size() / 2] ^= 0x10;
+        std::ofstream       output(damaged, std::ios::binary);
+        output.write(bytes.data(), bytes.size());
+    }
+    report.expect(runsCleanly([&]{ModelFile::open(path, true);}), "intact file passes checksum");
+    report.expect(!runsCleanly([&]{ModelFile::open(damaged, true);}), "damaged file fails checksum");
+
+    TsetlinMachine::Snapshot    hollow;
+    hollow.modelArgs = tm.args();
+    report.expect(!runsCleanly([&]{ModelFile::write(path, hollow);}), "snapshot without arenas is not written");
+    report.expect(!runsCleanly([&]{ModelFile::writeDelta(path, hollow, 0, 1);}), "delta without arenas is not written");
+
+    TsetlinMachine::model   prunedModel = tm.prune();
+    TsetlinMachine          pruned(prunedModel);
+    const string            remapped = "modelFileCheck.remap.tmmd";
+    ModelFile::write(remapped, pruned);
+    report.expect(runsCleanly([&]{ModelFile::open(remapped, false);}), "pruned file with its remap opens");
+    {
+        ModelFile::Header   header;
+        std::fstream        file(remapped, std::ios::binary | std::ios::in | std::ios::out);
+        file.read((char*)&header, sizeof(header));
+        int32_t             outside = header.originalInputSize;
+        file.seekp(header.remapOffset);
+        file.write((const char*)&outside, sizeof(outside));
+    }
+    report.expect(pruned.args().inputRemap.size() > 0, "pruned machine stores an input remap");
+    report.expect(!runsCleanly([&]{ModelFile::open(remapped, false);}), "remap beyond originalInputSize is rejected without checksum");
+    for (const string &file : {path, damaged, remapped}) std::remove(file.c_str());
+    return report.exitCode();
+}
@@ -0,0 +1,27 @@
+#include "MappedDataset.h"
+#include "io.h"
+#include "nucleotides.h"
+using std::vector;
+using std::string;
+
+/// @brief Convert sequence and response CSVs into packed dataset files for out-of-core training.
+///        Usage: pack [seqs.csv] [response.csv] [classNum] [trainRatio] [outputPrefix]
+int main(int argc, char const *argv[])
+{
+    string  seqPath = argc > 1? argv[1] : "../data/siRNA/e2sall/e2sIncSeqs.csv";
+    string  responsePath = argc > 2? argv[2] : "../data/siRNA/e2sall/e2sIncResponse.csv";
+    int     classNum = argc > 3? std::stoi(argv[3]) : 2;
+    double  trainRatio = argc > 4? std::stod(argv[4]) : 0.9;
+    string  prefix = argc > 5? argv[5] : "./e2sInc";
+
+    nucTransformer  transformer;
+    vector<string>  seqs = readcsvline<string>(seqPath);
+    vector<double>  res = readcsvline<double>(responsePath);
+    dataset         data = transformer.parseAndDivide(seqs,res,trainRatio,classNum);
+
+    MappedDataset::write(prefix + "_train.tmpk", data.trainData, data.trainResponse);
+    MappedDataset::write(prefix + "_test.tmpk", data.testData, data.testResponse);
+    std::cout<<"Packed "<<data.trainData.size()<<" training and "<<data.testData.size()
+             <<" test samples of "<<data.trainData[0].size()<<" literals into "<<prefix<<"_*.tmpk"<<std::endl;
+    return 0;
+}
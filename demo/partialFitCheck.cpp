@@ -0,0 +1,76 @@
+#include "PackedDataset.h"
+#include "checkUtil.h"
+#include <cstring>
+
+// Bit-pack rows the way partialFit expects, one run of wordsPerSample words per sample.
+static vector<uint64_t> packWords(const vector<vector<int>> &rows, int wordsPerSample)
+{
+    vector<uint64_t> words(rows.size() * wordsPerSample, 0);
+    for (size_t i = 0; i < rows.size(); i++)
+    {
+        for (int k = 0; k < rows[i].size(); k++)
+        {
+            words[i * wordsPerSample + k / 64] |= (uint64_t)(rows[i][k] > 0) << (k % 64);
+        }
+    }
+    return words;
+}
+
+// New samples are learned on the spot, the loaded training set is neither extended nor reordered.
+int main()
+{
+    checkReport report;
+    toyData     toy = makeToyData(300, 40, 3, 30);
+    dataset     split;
+    split.trainData = toy.data;
+    split.trainResponse = toy.response;
+    PackedDataset::Handle   loaded = PackedDataset::share(split);
+    const size_t            loadedBytes = loaded->bytes();
+
+    TsetlinMachine::MachineArgs args = toyArgs(toy, 20);
+    args.shuffle = false;
+    TsetlinMachine fitted(args, {}), baseline(args, {});
+    fitted.load(loaded);
+    baseline.load(loaded);
+    fitted.train(2);
+    baseline.train(2);
+
+    toyData         fresh = makeToyData(60, 40, 3, 31);
+    vector<uint8_t> freshLabels;
+    for (auto &row : fresh.data) freshLabels.push_back(row[5]? 1 : 2);    // A rule the loaded set never taught.
+    vector<uint64_t> freshWords = packWords(fresh.data, fitted.wordsPerSample());
+    const long      useCount = loaded.use_count();
+    for (int pass = 0; pass < 10; pass++) fitted.partialFit(freshWords, freshLabels);
+
+    vector<vector<int>> fittedPredicted = fitted.loadAndPredict(fresh.data);
+    vector<vector<int>> basePredicted = baseline.loadAndPredict(fresh.data);
+    int fittedCorrect = 0, baseCorrect = 0;
+    for (int i = 0; i < fresh.data.size(); i++)
+    {
+        fittedCorrect += fittedPredicted[i][freshLabels[i]];
+        baseCorrect += basePredicted[i][freshLabels[i]];
+    }
+    report.expect(fittedPredicted != basePredicted, "partialFit changes predictions on new samples");
+    report.expect(fittedCorrect > baseCorrect, "partialFit moves predictions toward new labels");
+    report.expect(fitted.sampleOrder() == baseline.sampleOrder() &&
+                  fitted.sampleOrder().size() == toy.data.size(), "loaded sample order is untouched");
+    report.expect(loaded.use_count() == useCount && loaded->bytes() == loadedBytes, "loaded set is neither copied nor grown");
+
+    TsetlinMachine single(args, {}), batched(args, {});
+    single.load(loaded);
+    batched.load(loaded);
+    single.train(1);
+    batched.train(1);
+    vector<uint64_t> firstWords(freshWords.begin(), freshWords.begin() + single.wordsPerSample());
+    single.update(firstWords, freshLabels[0]);
+    batched.partialFit(firstWords, std::span<const uint8_t>(freshLabels.data(), 1));
+    TsetlinMachine::model singleModel = single.exportModel(), batchedModel = batched.exportModel();
+    bool isSame = true;
+    for (int j = 0; j < toy.outputSize; j++)
+    {
+        isSame &= (singleModel.automatas[j].positiveClauses == batchedModel.automatas[j].positiveClauses) &&
+                  (singleModel.automatas[j].negativeClauses == batchedModel.automatas[j].negativeClauses);
+    }
+    report.expect(isSame, "update equals partialFit of one sample");
+    return report.exitCode();
+}
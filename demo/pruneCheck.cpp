@@ -0,0 +1,33 @@
+#include "checkUtil.h"
+
+// Pruning drops exactly the columns no clause includes and remaps the rest to their original columns.
+int main()
+{
+    checkReport report;
+    const int   inputSize = 20;
+    toyData     toy = makeToyData(200, inputSize, 2, 5);
+    TsetlinMachine::model crafted;
+    crafted.modelArgs = toyArgs(toy, 3);
+    crafted.automatas.resize(2);
+    vector<int> empty = craftClause(inputSize, {}, {});
+    crafted.automatas[0].positiveClauses = {craftClause(inputSize, {2}, {}), craftClause(inputSize, {2, 11}, {}), empty};
+    crafted.automatas[0].negativeClauses = {craftClause(inputSize, {}, {7}), empty, empty};
+    crafted.automatas[1].positiveClauses = {craftClause(inputSize, {7}, {2}), empty, empty};
+    crafted.automatas[1].negativeClauses = {craftClause(inputSize, {11}, {}), empty, empty};
+    TsetlinMachine tm(crafted);
+
+    TsetlinMachine::model   prunedModel = tm.prune();
+    TsetlinMachine          pruned(prunedModel);
+    report.expect(pruned.inputSize() == 3, "only the three included columns are kept");
+    report.expect(pruned.args().inputRemap == vector<int>({2, 7, 11}), "remap points to the kept columns");
+    report.expect(pruned.args().originalInputSize == inputSize, "rows keep their original width");
+    report.expect(prunedModel.automatas[1].positiveClauses[0] == craftClause(3, {1}, {0}), "kept literal states follow the remap");
+    report.expect(pruned.loadAndPredict(toy.data) == tm.loadAndPredict(toy.data), "pruned prediction equals original");
+    report.expect(pruned.predict(std::span<const uint8_t>(toy.rows)) == tm.predict(std::span<const uint8_t>(toy.rows)),
+                  "pruned byte-row prediction equals original");
+
+    TsetlinMachine::model twiceModel = pruned.prune();
+    report.expect(twiceModel.modelArgs.inputRemap == vector<int>({2, 7, 11}), "pruning again composes the remap");
+    report.expect(!(prunedModel.modelArgs == tm.exportModel().modelArgs), "pruned args differ from unpruned args");
+    return report.exitCode();
+}
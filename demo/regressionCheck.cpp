@@ -0,0 +1,63 @@
+#include "RegressionTsetlinMachine.h"
+#include "checkUtil.h"
+#include <algorithm>
+
+static RegressionTsetlinMachine::MachineArgs regressionArgs(uint64_t seed)
+{
+    RegressionTsetlinMachine::MachineArgs args;
+    args.inputSize = 24;
+    args.clauseNum = 60;
+    args.T = 30;
+    args.sLow = 3.9;
+    args.sHigh = 3.9;
+    args.dropoutRatio = 0;
+    args.seed = seed;
+    return args;
+}
+
+// Responses are rescaled onto the vote range, predictions stay inside it and training lowers the error.
+int main()
+{
+    checkReport report;
+    std::mt19937        rng(36);
+    vector<vector<int>> data(400, vector<int>(24, 0));
+    vector<double>      response(400, 0);
+    for (int i = 0; i < data.size(); i++)
+    {
+        for (int k = 0; k < 24; k++) data[i][k] = rng() & 1;
+        response[i] = 10 + 2 * data[i][0] + data[i][1] + 3 * data[i][2];    // Within [10, 16].
+    }
+
+    RegressionTsetlinMachine tm(regressionArgs(36));
+    tm.load(data, response);
+    RegressionTsetlinMachine::model range = tm.exportModel();
+    report.expect(range.low == 10 && range.high == 16, "load keeps the response range for rescaling");
+    double before = tm.meanAbsoluteError(data, response);
+    tm.train(30);
+    double after = tm.meanAbsoluteError(data, response);
+    report.expect(after < before / 2, "training halves the mean absolute error");
+
+    vector<double> predicted = tm.loadAndPredict(data);
+    report.expect(std::all_of(predicted.begin(), predicted.end(), [](double y){return y >= 10 && y <= 16;}),
+                  "predictions stay within [low, high]");
+
+    RegressionTsetlinMachine::model saved = tm.exportModel();
+    RegressionTsetlinMachine        rebuilt(saved);
+    report.expect(rebuilt.loadAndPredict(data) == predicted, "exported model predicts like its source");
+    RegressionTsetlinMachine        imported(regressionArgs(37));
+    imported.importModel(saved);
+    RegressionTsetlinMachine::model again = imported.exportModel();
+    report.expect(again.clauses == saved.clauses && again.low == saved.low && again.high == saved.high,
+                  "importModel restores clauses and range");
+
+    vector<double> constant(data.size(), 5);
+    RegressionTsetlinMachine flat(regressionArgs(38));
+    flat.load(data, constant);
+    RegressionTsetlinMachine::model flatRange = flat.exportModel();
+    flat.train(5);
+    predicted = flat.loadAndPredict(data);
+    report.expect(flatRange.low == 5 && flatRange.high == 6, "constant response maps onto a unit range");
+    report.expect(std::all_of(predicted.begin(), predicted.end(), [](double y){return y >= 5 && y <= 6;}),
+                  "constant response predictions stay in range");
+    return report.exitCode();
+}
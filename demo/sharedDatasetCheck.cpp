@@ -0,0 +1,62 @@
+#include "PackedDataset.h"
+#include "checkUtil.h"
+#include <thread>
+
+static bool sameState(TsetlinMachine &a, TsetlinMachine &b)
+{
+    TsetlinMachine::model modelA = a.exportModel(), modelB = b.exportModel();
+    for (int j = 0; j < modelA.automatas.size(); j++)
+    {
+        if(modelA.automatas[j].positiveClauses != modelB.automatas[j].positiveClauses) return false;
+        if(modelA.automatas[j].negativeClauses != modelB.automatas[j].negativeClauses) return false;
+    }
+    return true;
+}
+
+// Machines loading one packed dataset hold a reference to it instead of a copy, and train as if they owned it.
+int main()
+{
+    checkReport report;
+    toyData     train = makeToyData(300, 36, 3, 43), valid = makeToyData(80, 36, 3, 44);
+    dataset     split;
+    split.trainData = train.data;
+    split.trainResponse = train.response;
+    split.testData = valid.data;
+    split.testResponse = valid.response;
+    PackedDataset::Handle shared = PackedDataset::share(split);
+
+    const int   machineNum = 3;
+    vector<std::unique_ptr<TsetlinMachine>> machines;
+    for (int m = 0; m < machineNum; m++)
+    {
+        TsetlinMachine::MachineArgs args = toyArgs(train, 10 + 5 * m);
+        args.seed = 43 + m;
+        machines.emplace_back(std::make_unique<TsetlinMachine>(args, vector<string>()));
+        machines[m]->load(shared);
+    }
+    report.expect(shared.use_count() == 1 + machineNum, "every machine references the one packed dataset");
+
+    const size_t bytes = shared->bytes();
+    shared.reset();         // Machines alone keep the dataset alive.
+    vector<std::thread> workers;
+    for (int m = 0; m < machineNum; m++) workers.emplace_back([&, m]{machines[m]->train(3);});
+    for (auto &worker : workers) worker.join();
+
+    TsetlinMachine::MachineArgs args = toyArgs(train, 10);
+    args.seed = 43;
+    TsetlinMachine owner(args, {});
+    owner.load(train.data, train.response);
+    owner.train(3);
+    report.expect(sameState(*machines[0], owner), "training on the shared set equals training on an owned copy");
+    report.expect(bytes > 0 && machines[0]->sampleOrder().size() == train.data.size(), "shared set holds every training sample");
+
+    TsetlinMachine::PackedSet validation = owner.packSet(valid.data, valid.response);
+    PackedDataset::Handle again = PackedDataset::share(split);
+    report.expect(machines[0]->evaluate(again->validation()) == machines[0]->evaluate(validation),
+                  "validation split is packed like packSet");
+
+    TsetlinMachine::MachineArgs widerArgs = toyArgs(train, 10);
+    widerArgs.inputSize = 40;
+    report.expect(!runsCleanly([&]{TsetlinMachine wider(widerArgs, {}); wider.load(again);}), "dataset of another width is rejected");
+    return report.exitCode();
+}
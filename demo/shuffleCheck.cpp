@@ -0,0 +1,46 @@
+#include "checkUtil.h"
+#include <algorithm>
+#include <numeric>
+
+// A seed fixes the visiting order of every epoch, and each epoch still gets a fresh order.
+int main()
+{
+    checkReport report;
+    toyData     toy = makeToyData(200, 20, 3, 26);
+    TsetlinMachine::MachineArgs args = toyArgs(toy, 10);
+    args.seed = 26;
+    TsetlinMachine first(args, {}), second(args, {});
+    first.load(toy.data, toy.response);
+    second.load(toy.data, toy.response);
+
+    vector<int> identity(toy.data.size());
+    std::iota(identity.begin(), identity.end(), 0);
+    vector<vector<int>> orders;
+    bool isSameOrder = true;
+    for (int epoch = 0; epoch < 3; epoch++)
+    {
+        first.train(1);
+        second.train(1);
+        isSameOrder &= (first.sampleOrder() == second.sampleOrder());
+        orders.push_back(first.sampleOrder());
+    }
+    vector<int> sorted = orders[0];
+    std::sort(sorted.begin(), sorted.end());
+    report.expect(sorted == identity, "order is a permutation of loaded samples");
+    report.expect(orders[0] != identity, "order is shuffled");
+    report.expect(isSameOrder, "equal seeds give equal orders every epoch");
+    report.expect(orders[0] != orders[1] && orders[1] != orders[2], "each epoch draws a new order");
+
+    args.seed = 27;
+    TsetlinMachine other(args, {});
+    other.load(toy.data, toy.response);
+    other.train(1);
+    report.expect(other.sampleOrder() != orders[0], "another seed gives another order");
+
+    args.shuffle = false;
+    TsetlinMachine ordered(args, {});
+    ordered.load(toy.data, toy.response);
+    ordered.train(2);
+    report.expect(ordered.sampleOrder() == identity, "shuffle off keeps the loaded order");
+    return report.exitCode();
+}
@@ -47,31 +47,16 @@ int main(int argc, char const *argv[])
     TsetlinMachine tm(mArgs,tierTags);
     
     tm.load(train_seqs,train_scores);
-    for (int i = 0; i < epochNum; i++)
-    {
-        auto start = std::chrono::high_resolution_clock::now();
-        tm.train(1);
-        auto end = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> diff = end - start;
-        std::cout <<"### Epoch"<<i<< " training"<<" consumes : " << diff.count() << " s\n";
-    }
-    
-    vector<vector<int>> predict = tm.loadAndPredict(test_seqs);
-    int totalCorrect = 0;
-    for (int sample = 0; sample < predict.size(); sample++)
-    {
-        bool correct = true;
-        for (int digit = 0; digit < predict[0].size(); digit++)
-        {
-            if(predict[sample][digit] != test_scores[sample][digit])
-            {
-                correct = false;
-                break;
-            }
-        }
-        totalCorrect += correct;
-    }
-    auto precision = totalCorrect/(double) test_scores.size();
+    TsetlinMachine::PackedSet   validation = tm.packSet(test_seqs,test_scores);
+    TsetlinMachine::StopArgs    stopArgs;
+    stopArgs.evalInterval = 1;
+    stopArgs.patience = 3;
+    stopArgs.minDelta = 0.001;
+    auto start = std::chrono::high_resolution_clock::now();
+    auto precision = tm.train(epochNum, validation, stopArgs);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end - start;
+    std::cout <<"### Training with early stopping consumes : " << diff.count() << " s\n";
     std::cout<< "Precision:"<< precision<<std::endl;
     auto model = tm.exportModel();
     vector<string> headers{"NUC","NUCvoice","GC","GCvoice"};
@@ -0,0 +1,43 @@
+#include "checkUtil.h"
+
+// A shared snapshot unpacks to the exported model, and rebuilds or warm starts like it.
+int main()
+{
+    checkReport report;
+    toyData     toy = makeToyData(300, 40, 3, 12);
+    TsetlinMachine tm(toyArgs(toy, 30), {});
+    tm.load(toy.data, toy.response);
+    tm.train(3);
+    TsetlinMachine::SnapshotHandle  handle = tm.share();
+    TsetlinMachine::SnapshotHandle  copy = handle;
+    TsetlinMachine::model           exported = tm.exportModel();
+    TsetlinMachine::model           unpacked = TsetlinMachine::toModel(*copy);
+    bool isSame = true;
+    for (int j = 0; j < tm.outputSize(); j++)
+    {
+        isSame &= (exported.automatas[j].positiveClauses == unpacked.automatas[j].positiveClauses) &&
+                  (exported.automatas[j].negativeClauses == unpacked.automatas[j].negativeClauses);
+    }
+    report.expect(handle.use_count() == 2, "copies share one snapshot");
+    report.expect(isSame, "toModel equals exportModel");
+    TsetlinMachine restored(*handle);
+    report.expect(restored.loadAndPredict(toy.data) == tm.loadAndPredict(toy.data), "restored machine predicts like the original");
+
+    TsetlinMachine::MachineArgs wider = toyArgs(toy, 50);
+    TsetlinMachine fromModel(exported, wider), fromSnapshot(*handle, wider);
+    bool isSameWarm = true;
+    for (int j = 0; j < tm.outputSize(); j++)
+    {
+        const ClauseArena &a = fromModel.state(j), &b = fromSnapshot.state(j);
+        for (int no = 0; no < 30; no++)
+        {
+            for (int k : {no, no + 50})
+            {
+                isSameWarm &= std::equal(a.posInclusion(k), a.posInclusion(k) + a.blockNum(), b.posInclusion(k)) &&
+                              std::equal(a.negInclusion(k), a.negInclusion(k) + a.blockNum(), b.negInclusion(k));
+            }
+        }
+    }
+    report.expect(isSameWarm, "snapshot warm start keeps the same clauses as model warm start");
+    return report.exitCode();
+}
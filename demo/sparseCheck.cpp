@@ -0,0 +1,79 @@
+#include "SparseTsetlinMachine.h"
+#include "checkUtil.h"
+#include <algorithm>
+
+// Wide samples with a few active columns, class 1 exactly when column 7 is active.
+static void makeSparse(std::mt19937 &rng, int sampleNum, int inputSize,
+                       vector<vector<int>> &active, vector<vector<int>> &dense, vector<vector<int>> &response)
+{
+    for (int i = 0; i < sampleNum; i++)
+    {
+        vector<int> row;
+        if(i % 2) row.push_back(7);
+        while(row.size() < 12)
+        {
+            int literal = rng() % inputSize;
+            if(literal != 7 && std::find(row.begin(), row.end(), literal) == row.end()) row.push_back(literal);
+        }
+        std::sort(row.begin(), row.end());
+        vector<int> bits(inputSize, 0);
+        for (int literal : row) bits[literal] = 1;
+        active.push_back(row);
+        dense.push_back(bits);
+        response.push_back({i % 2 == 0, i % 2 == 1});
+    }
+}
+
+// The sparse machine answers like the dense machine trained on the same samples.
+int main()
+{
+    checkReport report;
+    const int   inputSize = 1000, clausePerOutput = 10;
+    std::mt19937        rng(37);
+    vector<vector<int>> active, dense, response, testActive, testDense, testResponse;
+    makeSparse(rng, 400, inputSize, active, dense, response);
+    makeSparse(rng, 200, inputSize, testActive, testDense, testResponse);
+
+    SparseTsetlinMachine::MachineArgs sparseArgs;
+    sparseArgs.inputSize = inputSize;
+    sparseArgs.outputSize = 2;
+    sparseArgs.clausePerOutput = clausePerOutput;
+    sparseArgs.T = 10;
+    sparseArgs.sLow = 1.5;                 // Low specificity keeps dense clauses off the many absent columns.
+    sparseArgs.sHigh = 1.5;
+    sparseArgs.dropoutRatio = 0;
+    sparseArgs.seed = 37;
+    SparseTsetlinMachine::MachineArgs flooredArgs = sparseArgs;
+    flooredArgs.stateFloor = 0;
+    report.expect(!runsCleanly([&]{SparseTsetlinMachine floored(flooredArgs, {});}), "non-negative stateFloor is rejected");
+
+    SparseTsetlinMachine sparse(sparseArgs, {});
+    sparse.load(active, response);
+    sparse.train(20);
+
+    TsetlinMachine::MachineArgs denseArgs;
+    denseArgs.inputSize = inputSize;
+    denseArgs.outputSize = 2;
+    denseArgs.clausePerOutput = clausePerOutput;
+    denseArgs.T = 10;
+    denseArgs.sLow = 1.5;
+    denseArgs.sHigh = 1.5;
+    denseArgs.dropoutRatio = 0;
+    denseArgs.seed = 37;
+    TsetlinMachine denseTm(denseArgs, {});
+    denseTm.load(dense, response);
+    denseTm.train(20);
+
+    vector<vector<int>> sparsePredicted = sparse.loadAndPredict(testActive);
+    vector<vector<int>> densePredicted = denseTm.loadAndPredict(testDense);
+    int agree = 0, correct = 0;
+    for (int i = 0; i < testResponse.size(); i++)
+    {
+        agree += (sparsePredicted[i] == densePredicted[i]);
+        correct += (sparsePredicted[i] == testResponse[i]);
+    }
+    report.expect(correct >= 0.95 * testResponse.size(), "sparse machine learns the active column rule");
+    report.expect(agree >= 0.95 * testResponse.size(), "sparse and dense predictions agree on unseen samples");
+    report.expect(sparse.trackedNum() < (size_t)2 * 2 * clausePerOutput * inputSize / 10, "clauses track a small share of literals");
+    return report.exitCode();
+}
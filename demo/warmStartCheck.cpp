@@ -0,0 +1,57 @@
+#include "checkUtil.h"
+
+// Clause states of 'count' clauses of every automata, starting at clause 'first' of each polarity.
+static bool sameClauses(TsetlinMachine::model &a, int firstA, TsetlinMachine::model &b, int firstB, int count)
+{
+    for (int j = 0; j < a.automatas.size(); j++)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if(a.automatas[j].positiveClauses[firstA + i] != b.automatas[j].positiveClauses[firstB + i]) return false;
+            if(a.automatas[j].negativeClauses[firstA + i] != b.automatas[j].negativeClauses[firstB + i]) return false;
+        }
+    }
+    return true;
+}
+
+// An imported model is the machine it came from, and a resized machine keeps the clauses that fit.
+int main()
+{
+    checkReport report;
+    toyData     toy = makeToyData(300, 30, 3, 33);
+    TsetlinMachine::MachineArgs args = toyArgs(toy, 20);
+    args.seed = 33;
+    TsetlinMachine source(args, {});
+    source.load(toy.data, toy.response);
+    source.train(4);
+    TsetlinMachine::model   saved = source.exportModel();
+    vector<vector<int>>     sourcePredicted = source.loadAndPredict(toy.data);
+
+    TsetlinMachine          rebuilt(saved);
+    TsetlinMachine::model   rebuiltModel = rebuilt.exportModel();
+    report.expect(sameClauses(rebuiltModel, 0, saved, 0, 20), "importModel restores every clause state");
+    report.expect(rebuilt.loadAndPredict(toy.data) == sourcePredicted, "imported machine predicts like its source");
+
+    TsetlinMachine::MachineArgs grownArgs = args, shrunkArgs = args, hotterArgs = args;
+    grownArgs.clausePerOutput = 32;
+    shrunkArgs.clausePerOutput = 8;
+    hotterArgs.T = 40;
+    TsetlinMachine          grown(saved, grownArgs), shrunk(saved, shrunkArgs), hotter(saved, hotterArgs);
+    TsetlinMachine          fresh(grownArgs, {});
+    TsetlinMachine::model   grownModel = grown.exportModel(), shrunkModel = shrunk.exportModel();
+    TsetlinMachine::model   hotterModel = hotter.exportModel(), freshModel = fresh.exportModel();
+    report.expect(grown.clausePerOutput() == 32 && sameClauses(grownModel, 0, saved, 0, 20), "grown machine keeps all learned clauses");
+    report.expect(sameClauses(grownModel, 20, freshModel, 20, 12), "extra clauses start like a fresh machine");
+    report.expect(grown.loadAndPredict(toy.data) == sourcePredicted, "fresh clauses do not change the vote");
+    report.expect(shrunk.clausePerOutput() == 8 && sameClauses(shrunkModel, 0, saved, 0, 8), "shrunk machine keeps the first clauses");
+    report.expect(hotter.args().T == 40 && sameClauses(hotterModel, 0, saved, 0, 20), "new T keeps every clause");
+
+    TsetlinMachine          fromSnapshot(source.snapshot(), grownArgs);
+    TsetlinMachine::model   snapshotModel = fromSnapshot.exportModel();
+    report.expect(sameClauses(snapshotModel, 0, grownModel, 0, 32), "snapshot warm start equals model warm start");
+
+    TsetlinMachine::MachineArgs widerArgs = args;
+    widerArgs.inputSize = 31;
+    report.expect(!runsCleanly([&]{TsetlinMachine rejected(saved, widerArgs);}), "model of another input size is rejected");
+    return report.exitCode();
+}
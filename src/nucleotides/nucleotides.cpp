@@ -407,6 +407,8 @@ dataset nucTransformer::parseAndDivide( const vector<string> &seqs,
     vector<vector<int>>     trainResponse;
     vector<vector<int>>     testData;
     vector<vector<int>>     testResponse;
+    vector<double>          trainValue;
+    vector<double>          testValue;
 
     vector<int> thisResponse;
     for (int i = 0; i < seqs.size(); i++)
@@ -416,11 +418,13 @@ dataset nucTransformer::parseAndDivide( const vector<string> &seqs,
         {
             trainData.emplace_back(totalData[i]);
             trainResponse.emplace_back(thisResponse);
+            trainValue.emplace_back(responses[i]);
         }
         else[[unlikely]]            // Picked to test set.
         {
             testData.emplace_back(totalData[i]);
             testResponse.emplace_back(thisResponse);
+            testValue.emplace_back(responses[i]);
         }
     }
     trainData.shrink_to_fit();
@@ -435,6 +439,8 @@ dataset nucTransformer::parseAndDivide( const vector<string> &seqs,
     result.trainResponse = trainResponse;
     result.testData = testData;
     result.testResponse = testResponse;
+    result.trainValue = trainValue;
+    result.testValue = testValue;
     result.trainSize = trainData.size();
     result.testSize = testData.size();
     result.tierTags = threshold2Tags(responseThreshold,true);
@@ -23,9 +23,11 @@
 
 #include "Automata.h"
 #include <thread>
+#include <algorithm>
 
 
-Automata::Automata(AutomataArgs args, vector<vector<__m512i>> &input, vector<int> &target)noexcept:
+Automata::Automata(AutomataArgs args,
+                    vector<int> &order)noexcept:
 _no(args.no),
 _inputSize(args.inputSize),
 _clauseNum(args.clauseNum),
@@ -33,45 +35,56 @@ _T(args.T),
 _sLow(args.sLow),
 _sHigh(args.sHigh),
 _dropoutRatio(args.dropoutRatio),
-_sharedInputData(input),
-_targets(target)
+_sampleOrder(order),
+_clauses(ClauseArena::ArenaArgs{2 * args.clauseNum, args.inputSize, args.hugePage, args.mapped})
 {
-    static pcg_extras::seed_seq_from<std::random_device> seed_source;
-    static pcg64_fast _rng(seed_source);
+    if(args.seed != 0)
+    {
+        std::seed_seq sequence{(uint32_t)args.seed, (uint32_t)(args.seed >> 32), (uint32_t)args.no};
+        _rng.seed(sequence);
+        if(args.mapped == nullptr) _clauses.seed(args.seed, args.no);  // Mapped state resumes its own streams.
+    }
+    else
+    {
+        pcg_extras::seed_seq_from<std::random_device> seed_source;
+        _rng.seed(seed_source);
+    }
     _voteSum = 0;
-    Clause::ClauseArgs cArgs;
+    _inputMask.resize(_clauses.blockNum(), 0);
+    _inputMaskInverse.resize(_clauses.blockNum(), 0);
 
-    cArgs.inputSize = args.inputSize;
-    for(int i = 0; i< args.clauseNum; i++)
+    for(int i = 0; i< args.clauseNum && args.mapped == nullptr; i++)
     {
-        cArgs.no = i;
-        cArgs.specificity = _sLow + i * (_sHigh - _sLow)/((double)_clauseNum);
-        
-        Clause temp(cArgs);
-        _positiveClauses.push_back(temp);
-        _negativeClauses.push_back(std::move(temp));
+        double specificity = _sLow + i * (_sHigh - _sLow)/((double)_clauseNum);
+        positiveClause(i).initialize(specificity);
+        negativeClause(i).initialize(specificity);
     }
 }
 
 
-/// @brief Forward function, doing vote for learning or predicting.
+/// @brief Forward function, doing vote for learning, clauses record their votes for feedback.
 /// @param datavec A single vector of input data containing _inputSize number of elements.
 /// @return Result of all clauses' vote.
-int Automata::forward(vector<__m512i> &datavec)noexcept
+int Automata::forward(const __m512i *datavec)noexcept
+{
+    _clauses.maskInput(datavec, _inputMask.data(), _inputMaskInverse.data());
+    return forward(_inputMask.data(), _inputMaskInverse.data());
+}
+
+/// @brief Forward function on input masks that are already computed.
+/// @param in Input masks of the sample.
+/// @param inInverse Complement of input masks within valid literals.
+/// @return Result of all clauses' vote.
+int Automata::forward(const __mmask16 *in, const __mmask16 *inInverse)noexcept
 {
-    //std::cout<< "Start forwarding, each sample consume "<< datavec.size()<<std::endl;
     int sum = 0;
-    for(auto    pos = _positiveClauses.begin();
-                pos < _positiveClauses.end();
-                pos ++)
+    for (int i = 0; i < _clauseNum; i++)
     {
-        sum+=pos->vote(datavec);
+        sum+=positiveClause(i).vote(in, inInverse);
     }
-    for (auto   neg = _negativeClauses.begin();
-                neg < _negativeClauses.end();
-                neg++)
+    for (int i = 0; i < _clauseNum; i++)
     {
-        sum-=neg->vote(datavec);
+        sum-=negativeClause(i).vote(in, inInverse);
     }
     return sum;
 }
@@ -79,7 +92,9 @@ int Automata::forward(vector<__m512i> &datavec)noexcept
 
 /// @brief Backward function, containing arrangement of two types of feedback.
 /// @param response Target response of this input vector.
-void Automata::backward(int &response)noexcept
+/// @param in Input masks of the sample.
+/// @param inInverse Complement of input masks within valid literals.
+void Automata::backward(int &response, const __mmask16 *in, const __mmask16 *inInverse)noexcept
 {
     int     clampedSum = std::min(_T, std::max(-_T, response));
     double   rescaleFactor = 1.0f / static_cast<double>(2 * _T);
@@ -103,13 +118,13 @@ void Automata::backward(int &response)noexcept
     {
         if((response==1) && actP0[i] && pick[i])
         {
-            _positiveClauses[i].feedbackTypeI();
-            _negativeClauses[i].feedbackTypeII();
+            positiveClause(i).feedbackTypeI(in, inInverse);
+            negativeClause(i).feedbackTypeII(in, inInverse);
         }
         if((response==0) && actP1[i] && pick[i])
         {
-            _positiveClauses[i].feedbackTypeII();
-            _negativeClauses[i].feedbackTypeI();
+            positiveClause(i).feedbackTypeII(in, inInverse);
+            negativeClause(i).feedbackTypeI(in, inInverse);
         }
     }
 }
@@ -125,34 +140,100 @@ bool Automata::modelIntegrityCheck(model &targetModel)
 }
 
 /// @brief Learning process including forward and backward of a single epoch.
-void Automata::learn()noexcept
+///        Samples are visited in the order given by TM, data itself is never moved.
+/// @param input Samples shared by all automatas of TM, possibly by other machines too.
+/// @param labels Class index of each sample, target response is (label == _no).
+void Automata::learn(const PackedData &input, const vector<int> &labels)noexcept
 {
-    for (int i = 0; i < _sharedInputData.size(); i++)
+    const int sampleNum = _sampleOrder.size();
+    for (int i = 0; i < sampleNum; i++)
     {
-        forward(_sharedInputData[i]);
-        backward(_targets[i]);
+        if(i + 1 < sampleNum)[[likely]]        // Hide latency of random access to next sample.
+        {
+            const __m512i *next = input[_sampleOrder[i + 1]];
+            for (int b = 0; b < input.stride(); b++)
+            {
+                _mm_prefetch((const char*)&next[b], _MM_HINT_T0);
+            }
+        }
+        int idx = _sampleOrder[i];
+        update(input[idx], (labels[idx] == _no)? 1:0);
     }
 }
 
-/// @brief Generate output using learned clauses in this automata
-/// @param input Given input 2D vector, shaped in ( sampleNum * _inputSize )
+/// @brief Forward and backward of one sample, which need not belong to shared dataset.
+/// @param sample Packed sample of _inputSize literals.
+/// @param response Target response of this sample.
+void Automata::update(const __m512i *sample, int response)noexcept
+{
+    forward(sample);
+    backward(response, _inputMask.data(), _inputMaskInverse.data());
+}
+
+/// @brief Forward and backward of one sample given by its input masks,
+///        so that masks can be computed once and shared by many automatas.
+/// @param in Input masks of the sample.
+/// @param inInverse Complement of input masks within valid literals.
+/// @param response Target response of this sample.
+void Automata::update(  const __mmask16 *in,
+                        const __mmask16 *inInverse,
+                        int response)noexcept
+{
+    forward(in, inInverse);
+    backward(response, in, inInverse);
+}
+
+/// @brief Generate output using learned clauses in this automata, re-entrant and lock free.
+/// @param input Packed samples.
 /// @return Vector of prediction structs, containing result of each example and it's predict confidence.
 vector<Automata::Prediction>
-Automata::predict (vector<vector<__m512i>> &input)noexcept
+Automata::predict (const PackedData &input)const noexcept
 {
-    vector<Prediction> result(input.size(),Prediction());
+    vector<Prediction>  result(input.size(),Prediction());
+    vector<__mmask16>   mask(_clauses.blockNum(), 0);       // Per call scratch, model is only read.
+    vector<__mmask16>   inverse(_clauses.blockNum(), 0);
     for (int i = 0; i < input.size(); i++)
     {
         Prediction thisPrediction;
-        int sum = forward(input[i]);
+        _clauses.maskInput(input[i], mask.data(), inverse.data());
+        int sum = vote(mask.data(), inverse.data());
         thisPrediction.result = (sum>0? 1:0);
         thisPrediction.confidence = sum/(double)_clauseNum;
+        thisPrediction.voteSum = sum;
         //std::cout<< "Automata "<<_no<<" prediction "<< i <<"is "<< thisPrediction.result<<" with confidence of: "<< thisPrediction.confidence<<std::endl;
         result[i] = thisPrediction;
     }
     return result;
 }
 
+/// @brief Vote of all clauses without touching any state, safe to call from many threads at once.
+/// @param in Input masks of the sample.
+/// @param inInverse Complement of input masks within valid literals.
+/// @return Fired positive clauses minus fired negative clauses.
+int Automata::vote(const __mmask16 *in, const __mmask16 *inInverse)const noexcept
+{
+    return partialVote(0, _clauseNum, in, inInverse);
+}
+
+/// @brief Vote of a range of clause pairs without touching any state, used by early-exit inference.
+/// @param first First clause index of both polarities.
+/// @param last One past the last clause index.
+/// @param in Input masks of the sample.
+/// @param inInverse Complement of input masks within valid literals.
+/// @return Fired positive clauses minus fired negative clauses in the range.
+int Automata::partialVote(  int first, int last,
+                            const __mmask16 *in,
+                            const __mmask16 *inInverse)const noexcept
+{
+    int sum = 0;
+    for (int i = first; i < last; i++)
+    {
+        sum += _clauses.evaluate(i, in, inInverse);
+        sum -= _clauses.evaluate(i + _clauseNum, in, inInverse);
+    }
+    return sum;
+}
+
 Automata::model Automata::exportModel()
 {
     model result;
@@ -161,15 +242,34 @@ Automata::model Automata::exportModel()
     neg.resize(_clauseNum);
     for (int i = 0; i < _clauseNum; i++)
     {
-        pos[i] = _positiveClauses[i].exportModel();
-        neg[i] = _negativeClauses[i].exportModel();
+        pos[i] = positiveClause(i).exportModel();
+        neg[i] = negativeClause(i).exportModel();
     }
     result.positiveClauses = pos;
     result.negativeClauses = neg;
     return result;
 }
 
-/*
+/// @brief Unpack clauses of an arena that belongs to no automata, e.g. one of a snapshot.
+/// @param state Arena of positive clauses followed by as many negative ones, taken by value
+///        since clause views need a mutable arena.
+/// @return Model in the layout of exportModel.
+Automata::model Automata::exportModel(ClauseArena state)
+{
+    const int   clauseNum = state.clauseNum() / 2;
+    model       result;
+    result.positiveClauses.resize(clauseNum);
+    result.negativeClauses.resize(clauseNum);
+    for (int i = 0; i < clauseNum; i++)
+    {
+        result.positiveClauses[i] = Clause(state, i).exportModel();
+        result.negativeClauses[i] = Clause(state, i + clauseNum).exportModel();
+    }
+    return result;
+}
+
+/// @brief Import all clauses from a model of the same shape.
+/// @param targetModel Model exported by an automata with identical clause number.
 void Automata::importModel(model &targetModel)
 {
     if(!Automata::modelIntegrityCheck(targetModel))
@@ -179,8 +279,44 @@ void Automata::importModel(model &targetModel)
     }
     for (int i = 0; i < _clauseNum; i++)
     {
-        _positiveClauses[i].importModel(targetModel.positiveClauses[i]);
-        _negativeClauses[i].importModel(targetModel.negativeClauses[i]);
+        positiveClause(i).importModel(targetModel.positiveClauses[i]);
+        negativeClause(i).importModel(targetModel.negativeClauses[i]);
     }
+    _clauses.markAllDirty();
 }
-*/
\ No newline at end of file
+
+/// @brief Import learned clauses from a model of different clause number,
+///        surplus clauses are kept freshly initialized and missing ones are dropped.
+/// @param targetModel Model exported by an automata with identical input size.
+void Automata::warmStart(model &targetModel)
+{
+    int sharedNum = std::min<int>(_clauseNum, targetModel.positiveClauses.size());
+    for (int i = 0; i < sharedNum; i++)
+    {
+        positiveClause(i).importModel(targetModel.positiveClauses[i]);
+        negativeClause(i).importModel(targetModel.negativeClauses[i]);
+    }
+    _clauses.markAllDirty();
+}
+
+/// @brief Warm start from the arena of another automata without unpacking,
+///        literal blocks of shared clauses are copied and surplus clauses are kept fresh.
+/// @param state Arena of an automata with identical input size.
+void Automata::warmStart(const ClauseArena &state)noexcept
+{
+    const int   sourceNum = state.clauseNum() / 2;
+    const int   sharedNum = std::min(_clauseNum, sourceNum);
+    const int   blockNum = _clauses.blockNum();
+    for (int i = 0; i < sharedNum; i++)
+    {
+        const int from[2] = {i, i + sourceNum};
+        const int to[2] = {i, i + _clauseNum};
+        for (int k = 0; k < 2; k++)
+        {
+            std::copy_n(state.positiveLiterals(from[k]), blockNum, _clauses.positiveLiterals(to[k]));
+            std::copy_n(state.negativeLiterals(from[k]), blockNum, _clauses.negativeLiterals(to[k]));
+            _clauses.refreshInclusion(to[k]);
+        }
+    }
+    _clauses.markAllDirty();
+}
\ No newline at end of file
@@ -21,7 +21,9 @@
 //  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 //  DEALINGS IN THE SOFTWARE.
 
+#pragma once
 #include "Clause.h"
+#include "PackedData.h"
 using std::vector;
 
 /// @brief A tsetlin automata is fundamental object to learn a digit of output from input.
@@ -35,15 +37,20 @@ public:
         int     T;
         double  sLow, sHigh;
         double  dropoutRatio;
+        bool    hugePage = false;   // Back clause arena with transparent huge pages.
+        char    *mapped = nullptr;  // Clause state borrowed from a mapped model file, skips initialization.
+        uint64_t seed = 0;          // Seed of feedback streams, 0 means seeded from random device.
     };
     struct Prediction
     {
         int     result;
         double  confidence;
+        int     voteSum;
         Prediction()
         {
             result = 0;
             confidence = 0;
+            voteSum = 0;
         }
     };
     struct model
@@ -62,23 +69,45 @@ private:
     const double                _sLow;
     const double                _sHigh;             // This is for multigranular clauses.
     const double                _dropoutRatio;      // Random dropout some clauses.
-    vector<vector<__m512i>>     &_sharedInputData;  // When start traning, reference dataset from TM.
-    vector<int>                 &_targets;
+    vector<int>                 &_sampleOrder;      // Visiting order of shared dataset, maintained by TM.
 
     pcg64_fast                  _rng;
     int                         _voteSum;           // Sum of all clauses' vote.
-    vector<Clause>              _positiveClauses;
-    vector<Clause>              _negativeClauses;
+    ClauseArena                 _clauses;           // Positive clauses in [0, _clauseNum), negative ones follow.
+    vector<__mmask16>           _inputMask;         // Masks of current sample, shared by all clauses.
+    vector<__mmask16>           _inputMaskInverse;
 
-    int     forward(vector<__m512i> &datavec)noexcept;
-    void    backward(int &response)noexcept;
+    Clause  positiveClause(int i)noexcept   {return Clause(_clauses, i);}
+    Clause  negativeClause(int i)noexcept   {return Clause(_clauses, i + _clauseNum);}
+
+    int     forward(const __m512i *datavec)noexcept;
+    int     forward(const __mmask16 *in, const __mmask16 *inInverse)noexcept;
+    void    backward(int &response, const __mmask16 *in, const __mmask16 *inInverse)noexcept;
     bool    modelIntegrityCheck(model &targetModel);
 public:
-    Automata(AutomataArgs args, vector<vector<__m512i>> &input, vector<int> &target)noexcept;
+    Automata(  AutomataArgs args,
+                vector<int> &order)noexcept;
 
-    void                learn()noexcept;
-    vector<Prediction>  predict(vector<vector<__m512i>> &input)noexcept;
+    void                learn(const PackedData &input, const vector<int> &labels)noexcept;
+    void                update(const __m512i *sample, int response)noexcept;
+    void                update( const __mmask16 *in,
+                                const __mmask16 *inInverse,
+                                int response)noexcept;
+    vector<Prediction>  predict(const PackedData &input)const noexcept;
+    int                 vote(const __mmask16 *in, const __mmask16 *inInverse)const noexcept;
+    int                 partialVote(int first, int last,
+                                    const __mmask16 *in,
+                                    const __mmask16 *inInverse)const noexcept;
 
     model               exportModel();
-    //void                importModel(model &targetModel);
+    void                importModel(model &targetModel);
+    void                warmStart(model &targetModel);
+    void                warmStart(const ClauseArena &state)noexcept;
+
+    static model        exportModel(ClauseArena state);
+
+    void                restrictLiterals(const vector<__mmask16> &mask)noexcept {_clauses.setLiteralMask(mask.data());}
+    const ClauseArena&  state()const noexcept                   {return _clauses;}
+    ClauseArena&        state()noexcept                         {return _clauses;}
+    void                restore(const ClauseArena &state)noexcept {_clauses = state; _clauses.markAllDirty();}
 };
\ No newline at end of file
@@ -0,0 +1,233 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "Checkpointer.h"
+#include <iostream>
+#include <filesystem>
+
+Checkpointer::Checkpointer(CheckpointArgs args):
+_args(args),
+_isWriting(false),
+_isStopping(false),
+_writtenEpoch(-1),
+_hasBase(false),
+_baseChecksum(0),
+_chainLength(0),
+_writtenBytes(0)
+{
+    if(_args.path.empty() || _args.interval <= 0 || _args.maxChainLength < 0)
+    {
+        std::cout<<"Checkpoint arguments failed integrity check."<<std::endl;
+        throw;
+    }
+    _writer = std::thread(&Checkpointer::writerLoop, this);
+}
+
+/// @brief Write what is still pending, then stop the writer.
+Checkpointer::~Checkpointer()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _cv.notify_all();
+    _writer.join();
+}
+
+/// @brief Take over a snapshot, returns without waiting for disk.
+/// @param snapshot Snapshot of machine state, replaces one not picked up by writer yet.
+void
+Checkpointer::submit(TsetlinMachine::Snapshot &&snapshot)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(_pending)        // Changes of the dropped snapshot are not on disk yet.
+        {
+            for (size_t j = 0; j < snapshot.arenas.size(); j++) snapshot.arenas[j].mergeDirty(_pending->arenas[j]);
+        }
+        _pending = std::make_unique<TsetlinMachine::Snapshot>(std::move(snapshot));
+    }
+    _cv.notify_all();
+}
+
+/// @brief Block until every submitted snapshot is on disk.
+void
+Checkpointer::flush()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [&]{return !_pending && !_isWriting;});
+}
+
+/// @return Bytes of all checkpoint and delta files written so far.
+size_t
+Checkpointer::writtenBytes()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _writtenBytes;
+}
+
+/// @return Epoch of the newest checkpoint on disk, -1 before the first one.
+long
+Checkpointer::writtenEpoch()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _writtenEpoch;
+}
+
+void
+Checkpointer::writerLoop()noexcept
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(true)
+    {
+        _cv.wait(lock, [&]{return _pending || _isStopping;});
+        if(!_pending) return;
+        std::unique_ptr<TsetlinMachine::Snapshot> snapshot = std::move(_pending);
+        _isWriting = true;
+        lock.unlock();
+
+        writeCheckpoint(*snapshot);
+
+        lock.lock();
+        _isWriting = false;
+        _cv.notify_all();
+    }
+}
+
+/// @brief Write a delta when the chain has room, otherwise a new base, aside and then renamed.
+///        A delta stores pos and neg blocks with an entry each, so past half of the blocks
+///        dirty a base is smaller. Only the writer thread touches chain state.
+void
+Checkpointer::writeCheckpoint(const TsetlinMachine::Snapshot &snapshot)
+{
+    size_t dirtyNum = 0, blockNum = 0;
+    for (const ClauseArena &arena : snapshot.arenas)
+    {
+        dirtyNum += arena.dirtyNum();
+        blockNum += (size_t)arena.clauseNum() * arena.blockNum();
+    }
+    const bool      isDelta = _hasBase && (_chainLength < _args.maxChainLength) && (2 * dirtyNum <= blockNum);
+    const string    target = isDelta? deltaPath(_args.path, _chainLength + 1) : _args.path;
+    const string    aside = target + ".tmp";
+    std::error_code error;
+    size_t          bytes = 0;
+    uint64_t        baseChecksum = 0;
+    if(isDelta)
+    {
+        bytes = ModelFile::writeDelta(aside, snapshot, _baseChecksum, _chainLength + 1);
+    }
+    else
+    {
+        baseChecksum = ModelFile::write(aside, snapshot);
+        bytes = std::filesystem::file_size(aside, error);
+    }
+    std::filesystem::rename(aside, target, error);
+    if(error)
+    {
+        std::cout<<"Checkpoint "<<target<<" is not replaced: "<<error.message()<<std::endl;
+        _hasBase = false;           // Changes of this snapshot are lost, next one must be full.
+        return;
+    }
+    if(isDelta)
+    {
+        _chainLength++;
+    }
+    else
+    {
+        removeDeltas(_args.path);   // They name the replaced base and would be skipped anyway.
+        _hasBase = true;
+        _baseChecksum = baseChecksum;
+        _chainLength = 0;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _writtenEpoch = snapshot.epoch;
+    _writtenBytes += bytes;
+}
+
+/// @return Path of a delta file in the chain of a checkpoint.
+string
+Checkpointer::deltaPath(const string &path, int sequence)
+{
+    return path + ".delta" + std::to_string(sequence);
+}
+
+/// @brief Remove the whole delta chain of a checkpoint.
+void
+Checkpointer::removeDeltas(const string &path)
+{
+    std::error_code error;
+    for (int k = 1; std::filesystem::remove(deltaPath(path, k), error); k++);
+}
+
+/// @brief Find the checkpoint to resume from.
+/// @param path Checkpoint file given in CheckpointArgs.
+/// @return Mapped checkpoint whose header carries the trained epochs, nullptr if none exists.
+std::shared_ptr<ModelFile>
+Checkpointer::latest(const string &path)
+{
+    if(!std::filesystem::exists(path)) return nullptr;
+    return ModelFile::open(path);
+}
+
+/// @brief Bring a machine built from the base checkpoint up to the newest delta of its chain.
+///        Resumed runs start a new chain with a full base, so dirty state is cleared.
+/// @param path Checkpoint file given in CheckpointArgs.
+/// @param base Base checkpoint returned by latest.
+/// @param machine Machine built from base.
+/// @return Epochs trained at the newest applied checkpoint.
+long
+Checkpointer::replay(const string &path, const ModelFile &base, TsetlinMachine &machine)
+{
+    long epoch = base.header().epoch;
+    for (int k = 1; ; k++)
+    {
+        long deltaEpoch = ModelFile::applyDelta(deltaPath(path, k), base.header().checksum, k, machine);
+        if(deltaEpoch < 0) break;
+        epoch = deltaEpoch;
+    }
+    for (int j = 0; j < machine.outputSize(); j++)
+    {
+        machine.state(j).clearDirty();
+    }
+    return epoch;
+}
+
+/// @brief Squash the delta chain of a checkpoint into a new base.
+/// @param path Checkpoint file given in CheckpointArgs.
+void
+Checkpointer::compact(const string &path)
+{
+    std::shared_ptr<ModelFile> base = latest(path);
+    if(!base) return;
+    TsetlinMachine  machine(base);
+    long            epoch = replay(path, *base, machine);
+    std::error_code error;
+    ModelFile::write(path + ".tmp", machine.snapshot(epoch));
+    std::filesystem::rename(path + ".tmp", path, error);
+    if(error)
+    {
+        std::cout<<"Checkpoint "<<path<<" is not compacted: "<<error.message()<<std::endl;
+        return;
+    }
+    removeDeltas(path);
+}
@@ -0,0 +1,83 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include <memory>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "TsetlinMachine.h"
+#include "ModelFile.h"
+using std::string;
+
+/// @brief Background writer of training checkpoints. Training threads hand over memcpy
+///        snapshots and continue at once, a single writer thread serializes them in model
+///        file format. Files are written aside and renamed, so a crash never leaves a torn
+///        checkpoint. When writing falls behind, a pending snapshot is replaced by a newer one.
+///        With a chain length, checkpoints after a full base only store blocks changed since
+///        the previous one. A new base is written once the chain is full or most blocks changed.
+class Checkpointer{
+public:
+    struct CheckpointArgs
+    {
+        string  path;               // Checkpoint file, overwritten atomically.
+        int     interval = 1;       // Epochs between checkpoints.
+        int     maxChainLength = 0; // Deltas written on top of one base, 0 writes full checkpoints only.
+    };
+
+private:
+    const CheckpointArgs                        _args;
+    std::mutex                                  _mutex;
+    std::condition_variable                     _cv;
+    std::unique_ptr<TsetlinMachine::Snapshot>   _pending;
+    bool                                        _isWriting;
+    bool                                        _isStopping;
+    long                                        _writtenEpoch;
+    bool                                        _hasBase;       // A base written by this checkpointer is on disk.
+    uint64_t                                    _baseChecksum;
+    int                                         _chainLength;
+    size_t                                      _writtenBytes;
+    std::thread                                 _writer;
+
+    void            writerLoop()noexcept;
+    void            writeCheckpoint(const TsetlinMachine::Snapshot &snapshot);
+    static string   deltaPath(const string &path, int sequence);
+    static void     removeDeltas(const string &path);
+
+public:
+    Checkpointer(CheckpointArgs args);
+    ~Checkpointer();
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+
+    void    submit(TsetlinMachine::Snapshot &&snapshot);
+    void    flush();
+    long    writtenEpoch();
+    size_t  writtenBytes();
+    int     interval()const noexcept    {return _args.interval;}
+
+    static std::shared_ptr<ModelFile>   latest(const string &path);
+    static long                         replay(const string &path, const ModelFile &base, TsetlinMachine &machine);
+    static void                         compact(const string &path);
+};
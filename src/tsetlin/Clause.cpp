@@ -25,54 +25,28 @@
 using std::vector;
 using std::cout, std::endl;
 
-Clause::Clause(ClauseArgs args)noexcept:
-_no(args.no),
-_literalNum(args.inputSize),
-_s(args.specificity), _sInv(1.0/_s), _sInvConj(1.0-_sInv),
-_blockNum(args.inputSize/16 + (args.inputSize%16==0? 0:1))
+Clause::Clause(ClauseArena &arena, int no)noexcept:
+_arena(arena),
+_no(no),
+_literalNum(arena.literalNum()),
+_blockNum(arena.blockNum())
 {
-    
-    pcg_extras::seed_seq_from<std::random_device> seed_source;
-    pcg64_fast          _rng(seed_source);
-
-    _positiveLiteralBlocks.resize(_blockNum, _zeros);
-    _posInclusionMaskBlocks.resize(_blockNum, _zeroMask);
-    _posExclusionMaskBlocks.resize(_blockNum, _zeroMask);
-
-    _negativeLiteralBlocks.resize(_blockNum, _zeros);
-    _negInclusionMaskBlocks.resize(_blockNum, _zeroMask);
-    _negExclusionMaskBlocks.resize(_blockNum, _zeroMask);
-    _inputMaskBlocks.resize(_blockNum, _zeroMask);
-    _inputMaskBlocksInverse.resize(_blockNum, _zeroMask);
-
-    // Compact memory usage.
-    _positiveLiteralBlocks.shrink_to_fit();
-    _posInclusionMaskBlocks.shrink_to_fit();
-    _posExclusionMaskBlocks.shrink_to_fit();
-    _negativeLiteralBlocks.shrink_to_fit();
-    _negInclusionMaskBlocks.shrink_to_fit();
-    _negExclusionMaskBlocks.shrink_to_fit();
-    _inputMaskBlocks.shrink_to_fit();
-    _inputMaskBlocksInverse.shrink_to_fit();
-    
-    int remainder = _literalNum%16;         // Deal with boundary problem.
-    int lastMaskInt = 0;
-    for (int offset = 0; offset < remainder; offset++)
-    {
-        lastMaskInt += (1<<offset);
-    }
-    _lastValidMask = _mm512_int2mask(lastMaskInt);
+}
 
-    _vote = 0;
+/// @brief Assign granular of this clause, literal states are already zeroed by arena.
+/// @param specificity Parameter 's' of this clause.
+void Clause::initialize(double specificity)noexcept
+{
+    _arena.sInv(_no) = 1.0/specificity;
+    _arena.sInvConj(_no) = 1.0 - _arena.sInv(_no);
 }
 
 /// @brief Pack and 'align' the original vector of int to 512Byte pack with zero-padding if size not equal to 16-mer.
 /// @param original Original vector of 32bit integer.
-/// @return Vector of packed and zero-padded __m512i pack vector.
-vector<__m512i>
-Clause::pack(vector<int> &original)noexcept
+/// @param target Destination of _blockNum packed blocks.
+void
+Clause::pack(vector<int> &original, __m512i *target)noexcept
 {
-    int packNum = original.size()/16 + (original.size()%16==0? 0:1);
     alignas(64) struct pack{
         int data[16];
         pack(){
@@ -83,8 +57,7 @@ Clause::pack(vector<int> &original)noexcept
             
         }
     };
-    vector<__m512i> result(packNum, _mm512_set1_epi32(0));
-    for (int i = 0; i < packNum; i++)
+    for (int i = 0; i < _blockNum; i++)
     {
         pack thisPack;
         for (int j = 0; j < 16; j++)
@@ -92,14 +65,12 @@ Clause::pack(vector<int> &original)noexcept
             thisPack.data[j] = (i*16+j)<(original.size())? original[i*16+j] : 0;
         }
         
-        result[i] = _mm512_loadu_epi32(&thisPack);
+        target[i] = _mm512_loadu_epi32(&thisPack);
     }
-    result.shrink_to_fit();
-    return result;
 }
 
 vector<int>
-Clause::unpack(vector<__m512i> &original)noexcept
+Clause::unpack(const __m512i *original)noexcept
 {
     alignas(64) struct pack{
         int data[16];
@@ -125,157 +96,120 @@ Clause::unpack(vector<__m512i> &original)noexcept
     return result;
 }
 
-/*
 /// @brief Check model integrity before importing
-/// @param targetModel Model that user intend to import
+/// @param targetModel Literal states that user intend to import
 /// @return Boolean value of the integrity
-bool Clause::modelIntegrityCheck(model &targetModel)
+bool Clause::modelIntegrityCheck(vector<int> &targetModel)
 {
-    bool isRightLength =    targetModel.literals.size() == 2* _literalNum;
-    bool isRightPlace = (targetModel.no == _no);
-    return isRightLength && isRightPlace;
+    bool isRightLength =    targetModel.size() == 2* _literalNum;
+    return isRightLength;
 }
-*/
 
 /// @brief Vote function used for both train and predict procedure.
-/// @param in Data vector that in the shape of ( 1, _literalNum )
+/// @param in Input masks of current sample, shaped in ( 1, _blockNum ).
+/// @param inInverse Complement of input masks within valid literals.
 /// @return Vote result, 0 or 1.
-int Clause::vote(vector<__m512i> &in)noexcept
+int Clause::vote(const __mmask16 *in, const __mmask16 *inInverse)noexcept
 {
-    vector<__mmask16>   posWrong(_blockNum, _zeroMask);
-    vector<__mmask16>   negWrong(_blockNum, _zeroMask);
-    
-    for (int i = 0; i < _blockNum; i++)           // Run once per data input.
-    {
-        _posInclusionMaskBlocks[i] = _mm512_cmpge_epi32_mask(_positiveLiteralBlocks[i], _zeros);
-        _negInclusionMaskBlocks[i] = _mm512_cmpge_epi32_mask(_negativeLiteralBlocks[i], _zeros);
-        _inputMaskBlocks[i] = _mm512_cmpgt_epi32_mask(in[i], _zeros);                // Greater than zero (only possible value is one)
-
-        _posExclusionMaskBlocks[i] = _knot_mask16(_posInclusionMaskBlocks[i]);
-        _negExclusionMaskBlocks[i] = _knot_mask16(_negInclusionMaskBlocks[i]);
-        _inputMaskBlocksInverse[i] = _knot_mask16(_inputMaskBlocks[i]);
-        
-        if(i == (_blockNum-1))[[unlikely]]    // Last block, may have boundary problem.
-        {
-            _posExclusionMaskBlocks[i] = _kand_mask16(_posExclusionMaskBlocks[i], _lastValidMask);
-            _negExclusionMaskBlocks[i] = _kand_mask16(_negExclusionMaskBlocks[i], _lastValidMask);
-            _inputMaskBlocksInverse[i] = _kand_mask16(_inputMaskBlocksInverse[i], _lastValidMask);
-        }
-    }
-    bool posNoProblem = true, negNoProblem= true;
-    bool hasProblem;
-    for (int i = 0; i < _blockNum; i++)
-    {
-        posWrong[i] =  _kor_mask16( posWrong[i],
-                                    _kand_mask16(   _posInclusionMaskBlocks[i],
-                                                    _inputMaskBlocksInverse[i]));   // Included but input=0, positive literal wrong.
-
-        negWrong[i] =  _kor_mask16( negWrong[i],
-                                    _kand_mask16(   _negInclusionMaskBlocks[i],
-                                                    _inputMaskBlocks[i]));          // Included but input=1, negative literal wrong.
-        posNoProblem = (_mm512_mask2int(posWrong[i]) == 0 );    // So far so good.
-        negNoProblem = (_mm512_mask2int(negWrong[i]) == 0 );
-        hasProblem = !(posNoProblem && negNoProblem);
-        if(hasProblem)[[likely]] break;         // Break when first unsatisfied literal occured.
-    }
-    int result = (hasProblem? 0:1);
-    _vote = result;
+    int result = _arena.evaluate(_no, in, inInverse)? 1:0;
+    _arena.vote(_no) = result;
     return result;
 }
 
 /// @brief Reinforce positive and negative literals according to 's' ,input, previous vote.
-void Clause::feedbackTypeI()noexcept
+/// @param in Input masks of previous sample.
+/// @param inInverse Complement of input masks within valid literals.
+void Clause::feedbackTypeI(const __mmask16 *in, const __mmask16 *inInverse)noexcept
 {
-    std::discrete_distribution<> d({_sInv, _sInvConj});
-    vector<int>                  radical(_literalNum,0);
-    vector<int>                  conservative(_literalNum,0);
-    vector<__m512i>              radicalBlock(_blockNum, _zeros);
-    vector<__m512i>              conservativeBlock(_blockNum, _zeros);
-    vector<__mmask16>            radicalPosMaskBlock(_blockNum, _zeroMask);
-    vector<__mmask16>            conservativeNegMaskBlock(_blockNum, _zeroMask);
-    vector<__mmask16>            conservativeNegMaskBlock2(_blockNum, _zeroMask);
-
-    for (int i = 0; i < _literalNum; i++)
-    {
-        radical[i] =        (d(_rng)==1);   // Fill 'true' with possibility of _sInvConj
-        conservative[i] =   (d(_rng)==0);   // Complement possibility, but not correlated to radical[].
-    }
-    radicalBlock = pack(radical); conservativeBlock = pack(conservative);
+    std::uniform_real_distribution<double>  d(0.0, 1.0);
+    pcg64_fast          &rng = _arena.rng(_no);
+    const double        sInv = _arena.sInv(_no);
+    const double        sInvConj = _arena.sInvConj(_no);
+    __m512i             *positiveLiterals = _arena.positiveLiterals(_no);
+    __m512i             *negativeLiterals = _arena.negativeLiterals(_no);
+    const bool          isFired = _arena.vote(_no);
 
     for (int i = 0; i < _blockNum; i++)
     {
-        radicalPosMaskBlock[i] = _mm512_cmpeq_epi32_mask(radicalBlock[i], _ones);
-        conservativeNegMaskBlock[i] = _mm512_cmpeq_epi32_mask(conservativeBlock[i], _ones);
-        conservativeNegMaskBlock2[i] = _knot_mask16(radicalPosMaskBlock[i]);
-        if(i == (_blockNum-1))[[unlikely]]
+        const bool isLast = (i == (_blockNum-1));
+        const int  width = isLast? _literalNum - i*16 : 16;
+        int radicalInt = 0, conservativeInt = 0;
+        for (int offset = 0; offset < width; offset++)
         {
-            conservativeNegMaskBlock2[i] = _kand_mask16(conservativeNegMaskBlock2[i], _lastValidMask);
+            radicalInt      |= (d(rng) < sInvConj) << offset;   // Fill 'true' with possibility of _sInvConj
+            conservativeInt |= (d(rng) < sInv) << offset;       // Complement possibility, but not correlated to radical.
         }
-    }
-    if(_vote)
-    {
-        for (int i = 0; i < _blockNum; i++)
-        {
-            _positiveLiteralBlocks[i] = _mm512_mask_add_epi32(  _positiveLiteralBlocks[i],
-                                                                _kand_mask16(   _inputMaskBlocks[i],
-                                                                                radicalPosMaskBlock[i]),
-                                                                _positiveLiteralBlocks[i], _ones);
+        __mmask16 radicalPosMask = _mm512_int2mask(radicalInt);
+        __mmask16 conservativeNegMask = _mm512_int2mask(conservativeInt);
 
-            _positiveLiteralBlocks[i] = _mm512_mask_add_epi32(  _positiveLiteralBlocks[i],
-                                                                _kand_mask16(   _inputMaskBlocksInverse[i],
-                                                                                conservativeNegMaskBlock[i]),
-                                                                _positiveLiteralBlocks[i], _negOnes);
-
-            _negativeLiteralBlocks[i] = _mm512_mask_add_epi32(  _negativeLiteralBlocks[i],
-                                                                _kand_mask16(   _inputMaskBlocks[i],
-                                                                                conservativeNegMaskBlock[i]),
-                                                                _negativeLiteralBlocks[i], _negOnes);
-
-            _negativeLiteralBlocks[i] = _mm512_mask_add_epi32(  _negativeLiteralBlocks[i],
-                                                                _kand_mask16(   _inputMaskBlocksInverse[i],
-                                                                                radicalPosMaskBlock[i]),
-                                                                _negativeLiteralBlocks[i], _ones);
+        if(isFired)
+        {
+            __mmask16 touched = _kand_mask16(_kor_mask16(in[i], inInverse[i]),
+                                             _kor_mask16(radicalPosMask, conservativeNegMask));
+            if(_mm512_mask2int(touched) != 0) _arena.markDirty(_no, i);
+            positiveLiterals[i] = _mm512_mask_add_epi32(positiveLiterals[i],
+                                                        _kand_mask16(in[i], radicalPosMask),
+                                                        positiveLiterals[i], _ones);
+
+            positiveLiterals[i] = _mm512_mask_add_epi32(positiveLiterals[i],
+                                                        _kand_mask16(inInverse[i], conservativeNegMask),
+                                                        positiveLiterals[i], _negOnes);
+
+            negativeLiterals[i] = _mm512_mask_add_epi32(negativeLiterals[i],
+                                                        _kand_mask16(in[i], conservativeNegMask),
+                                                        negativeLiterals[i], _negOnes);
+
+            negativeLiterals[i] = _mm512_mask_add_epi32(negativeLiterals[i],
+                                                        _kand_mask16(inInverse[i], radicalPosMask),
+                                                        negativeLiterals[i], _ones);
         }
-    }
-    else
-    {
-        for (int i = 0; i < _blockNum; i++)
+        else
         {
-            _positiveLiteralBlocks[i] = _mm512_mask_add_epi32(  _positiveLiteralBlocks[i],
-                                                                conservativeNegMaskBlock[i],
-                                                                _positiveLiteralBlocks[i], _negOnes);
-
-            _negativeLiteralBlocks[i] = _mm512_mask_add_epi32(  _negativeLiteralBlocks[i],
-                                                                conservativeNegMaskBlock2[i],
-                                                                _negativeLiteralBlocks[i], _negOnes);
+            __mmask16 conservativeNegMask2 = _knot_mask16(radicalPosMask);
+            if(isLast)[[unlikely]]
+            {
+                conservativeNegMask2 = _kand_mask16(conservativeNegMask2, _arena.lastValidMask());
+            }
+            if(_mm512_mask2int(_kor_mask16(conservativeNegMask, conservativeNegMask2)) != 0) _arena.markDirty(_no, i);
+            positiveLiterals[i] = _mm512_mask_add_epi32(positiveLiterals[i],
+                                                        conservativeNegMask,
+                                                        positiveLiterals[i], _negOnes);
+
+            negativeLiterals[i] = _mm512_mask_add_epi32(negativeLiterals[i],
+                                                        conservativeNegMask2,
+                                                        negativeLiterals[i], _negOnes);
         }
     }
+    _arena.refreshInclusion(_no);
 }
 
 
 /// @brief Reinforce positive and negative literals according to inclusion, input, previous vote.
-/// @param in Previous input vector.
-void Clause::feedbackTypeII()noexcept
+/// @param in Input masks of previous sample.
+/// @param inInverse Complement of input masks within valid literals.
+void Clause::feedbackTypeII(const __mmask16 *in, const __mmask16 *inInverse)noexcept
 {
-    if(_vote==0)return;
+    if(_arena.vote(_no)==0)return;
+    __m512i             *positiveLiterals = _arena.positiveLiterals(_no);
+    __m512i             *negativeLiterals = _arena.negativeLiterals(_no);
+    const __mmask16     *posInclusion = _arena.posInclusion(_no);
+    const __mmask16     *negInclusion = _arena.negInclusion(_no);
     for (int i = 0; i < _blockNum; i++)
     {
-        _positiveLiteralBlocks[i] = _mm512_mask_add_epi32(  _positiveLiteralBlocks[i],
-                                                            _kand_mask16(   _posExclusionMaskBlocks[i],
-                                                                            _inputMaskBlocksInverse[i]),
-                                                            _positiveLiteralBlocks[i], _ones);
+        __mmask16 posTouched = _kand_mask16(_knot_mask16(posInclusion[i]), inInverse[i]);
+        __mmask16 negTouched = _kand_mask16(_knot_mask16(negInclusion[i]), in[i]);
+        if(_mm512_mask2int(_kor_mask16(posTouched, negTouched)) != 0) _arena.markDirty(_no, i);
 
-        _negativeLiteralBlocks[i] = _mm512_mask_add_epi32(  _negativeLiteralBlocks[i], 
-                                                            _kand_mask16(   _negExclusionMaskBlocks[i],
-                                                                            _inputMaskBlocks[i]),
-                                                            _negativeLiteralBlocks[i], _ones);
+        positiveLiterals[i] = _mm512_mask_add_epi32(positiveLiterals[i], posTouched, positiveLiterals[i], _ones);
+        negativeLiterals[i] = _mm512_mask_add_epi32(negativeLiterals[i], negTouched, negativeLiterals[i], _ones);
     }
+    _arena.refreshInclusion(_no);
 }
 
 vector<int> Clause::exportModel()
 {
-    vector<int> posLitFilled = unpack(_positiveLiteralBlocks);
-    vector<int> negLitFilled = unpack(_negativeLiteralBlocks);
+    vector<int> posLitFilled = unpack(_arena.positiveLiterals(_no));
+    vector<int> negLitFilled = unpack(_arena.negativeLiterals(_no));
     vector<int> literals(_literalNum * 2, 0);
     for (int i = 0; i < _literalNum; i++)
     {
@@ -285,8 +219,9 @@ vector<int> Clause::exportModel()
     return literals;
 }
 
-/*
-void Clause::importModel(model &targetModel)
+/// @brief Overwrite literal states of this clause, in the layout produced by exportModel.
+/// @param targetModel Positive literal states followed by negative ones.
+void Clause::importModel(vector<int> &targetModel)
 {
     if(!Clause::modelIntegrityCheck(targetModel))[[unlikely]]
     {
@@ -297,11 +232,11 @@ void Clause::importModel(model &targetModel)
     vector<int> neg(_literalNum, 0);
     for (int i = 0; i < _literalNum; i++)
     {
-        pos[i] = targetModel.literals[i];
-        neg[i] = targetModel.literals[i+_literalNum];
+        pos[i] = targetModel[i];
+        neg[i] = targetModel[i+_literalNum];
     }
     
-    _positiveLiteralBlocks = pack(pos);
-    _negativeLiteralBlocks = pack(neg);
-}
-*/
\ No newline at end of file
+    pack(pos, _arena.positiveLiterals(_no));
+    pack(neg, _arena.negativeLiterals(_no));
+    _arena.refreshInclusion(_no);
+}
\ No newline at end of file
@@ -21,6 +21,7 @@
 //  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 //  DEALINGS IN THE SOFTWARE.
 
+#pragma once
 #include <vector>
 #include <iostream>
 #include <chrono>
@@ -28,53 +29,33 @@
 #include <immintrin.h>
 #include <assert.h>
 #include "pcg_random.hpp"
+#include "ClauseArena.h"
 using std::vector;
 
 /// @brief This clause use integer as literal as default.
+///        It is a lightweight view of one clause whose state lives in an arena.
 class Clause{
-public:
-    struct ClauseArgs
-    {
-        int     no;         // Unique tag of all clauses.
-        int     inputSize;
-        double  specificity;
-    };
-
 private:
-    const int               _no;
+    ClauseArena             &_arena;
+    const int               _no;                    // Index of this clause in arena.
     const int               _literalNum;
     const int               _blockNum;
-    const double            _s,_sInv,_sInvConj;     // Allocated granular.
 
     static const inline __m512i     _ones = _mm512_set1_epi32(1);
     static const inline __m512i     _zeros = _mm512_set1_epi32(0);
     static const inline __m512i     _negOnes= _mm512_set1_epi32(-1);
-    static const inline __mmask16   _zeroMask = _mm512_cmpeq_epi32_mask(_ones,_zeros);
-    static const inline __mmask16   _oneMask = _mm512_cmpeq_epi32_mask(_ones,_ones);
-
-    pcg64_fast              _rng;
-    vector<__m512i>         _positiveLiteralBlocks;
-    vector<__m512i>         _negativeLiteralBlocks;
-    vector<__mmask16>       _posInclusionMaskBlocks;
-    vector<__mmask16>       _negInclusionMaskBlocks;
-    vector<__mmask16>       _posExclusionMaskBlocks;
-    vector<__mmask16>       _negExclusionMaskBlocks;
-    vector<__mmask16>       _inputMaskBlocks;
-    vector<__mmask16>       _inputMaskBlocksInverse;
-    __mmask16               _lastValidMask;         // Boundary problem
-    
-    int                     _vote;
 
-    //bool                    modelIntegrityCheck(model &targetModel);
-    vector<int>             unpack(vector<__m512i> &original)noexcept;
-    vector<__m512i>         pack(vector<int> &original)noexcept;
+    bool                    modelIntegrityCheck(vector<int> &targetModel);
+    vector<int>             unpack(const __m512i *original)noexcept;
+    void                    pack(vector<int> &original, __m512i *target)noexcept;
 public:
-    Clause(ClauseArgs args)noexcept;
+    Clause(ClauseArena &arena, int no)noexcept;
 
-    int                     vote(vector<__m512i> &in)noexcept;
-    void                    feedbackTypeI()noexcept;
-    void                    feedbackTypeII()noexcept;
+    void                    initialize(double specificity)noexcept;
+    int                     vote(const __mmask16 *in, const __mmask16 *inInverse)noexcept;
+    void                    feedbackTypeI(const __mmask16 *in, const __mmask16 *inInverse)noexcept;
+    void                    feedbackTypeII(const __mmask16 *in, const __mmask16 *inInverse)noexcept;
 
     vector<int>             exportModel();
-    //void                    importModel(model &targetModel);
+    void                    importModel(vector<int> &targetModel);
 };
\ No newline at end of file
@@ -0,0 +1,323 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "ClauseArena.h"
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <bit>
+#include <new>
+#include <random>
+#include <type_traits>
+#include <sys/mman.h>
+
+static_assert(std::is_trivially_copyable_v<pcg64_fast>, "Clause RNG must be copyable by memcpy.");
+
+static inline size_t alignUp(size_t n, size_t alignment)
+{
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+ClauseArena::ClauseArena()noexcept:
+_clauseNum(0), _literalNum(0), _blockNum(0), _hugePage(false), _isBorrowed(false),
+_lastValidMask(0), _bytes(0), _base(nullptr)
+{
+    layout(nullptr);
+}
+
+ClauseArena::ClauseArena(ArenaArgs args):
+_clauseNum(args.clauseNum),
+_literalNum(args.inputSize),
+_blockNum(args.inputSize/16 + (args.inputSize%16==0? 0:1)),
+_hugePage(args.hugePage),
+_isBorrowed(false),
+_base(nullptr)
+{
+    int remainder = _literalNum%16;         // Deal with boundary problem.
+    _lastValidMask = (remainder == 0)? _mm512_int2mask(0xFFFF) : _mm512_int2mask((1<<remainder) - 1);
+
+    if(args.mapped != nullptr)              // State is already there, nothing to initialize.
+    {
+        _bytes = layout(nullptr);
+        _base = args.mapped;
+        _isBorrowed = true;
+        layout(_base);
+        return;
+    }
+    allocate();
+    for (int i = 0; i < _blockNum; i++)
+    {
+        _literalMask[i] = (i == _blockNum - 1)? _lastValidMask : _mm512_int2mask(0xFFFF);
+    }
+    pcg_extras::seed_seq_from<std::random_device> seed_source;
+    for (int no = 0; no < _clauseNum; no++)
+    {
+        for (int i = 0; i < _blockNum; i++)
+        {
+            positiveLiterals(no)[i] = _mm512_setzero_si512();
+            negativeLiterals(no)[i] = _mm512_setzero_si512();
+        }
+        refreshInclusion(no);
+        _sInv[no] = 0;
+        _sInvConj[no] = 1;
+        _votes[no] = 0;
+        new (&_rngs[no]) pcg64_fast(seed_source);
+    }
+    markAllDirty();                         // Nothing of a fresh arena has been checkpointed.
+}
+
+ClauseArena::ClauseArena(const ClauseArena &other):
+_clauseNum(other._clauseNum),
+_literalNum(other._literalNum),
+_blockNum(other._blockNum),
+_hugePage(other._hugePage),
+_isBorrowed(false),
+_lastValidMask(other._lastValidMask),
+_base(nullptr)
+{
+    allocate();
+    if(_bytes) std::memcpy(_base, other._base, _bytes);
+}
+
+ClauseArena::ClauseArena(ClauseArena &&other)noexcept:
+ClauseArena()
+{
+    *this = std::move(other);
+}
+
+ClauseArena& ClauseArena::operator=(const ClauseArena &other)
+{
+    if(this == &other) return *this;
+    bool isSameShape =  (_clauseNum == other._clauseNum) &&
+                        (_literalNum == other._literalNum) &&
+                        (_base != nullptr);
+    if(!isSameShape)        // Reuse allocation when only the state differs, e.g. snapshot restore.
+    {
+        release();
+        _clauseNum = other._clauseNum;
+        _literalNum = other._literalNum;
+        _blockNum = other._blockNum;
+        _hugePage = other._hugePage;
+        allocate();
+    }
+    _lastValidMask = other._lastValidMask;
+    if(_bytes) std::memcpy(_base, other._base, _bytes);
+    return *this;
+}
+
+ClauseArena& ClauseArena::operator=(ClauseArena &&other)noexcept
+{
+    if(this == &other) return *this;
+    release();
+    _clauseNum = other._clauseNum;
+    _literalNum = other._literalNum;
+    _blockNum = other._blockNum;
+    _hugePage = other._hugePage;
+    _lastValidMask = other._lastValidMask;
+    _bytes = other._bytes;
+    _base = other._base;
+    _isBorrowed = other._isBorrowed;
+    layout(_base);
+
+    other._base = nullptr;
+    other._isBorrowed = false;
+    other._clauseNum = other._literalNum = other._blockNum = 0;
+    other._bytes = other.layout(nullptr);
+    return *this;
+}
+
+ClauseArena::~ClauseArena()
+{
+    release();
+}
+
+/// @brief Carve all segments out of given base, or only measure them if base is null.
+/// @param base Start address of a 64-byte aligned allocation.
+/// @return Total bytes of all segments.
+size_t ClauseArena::layout(char *base)noexcept
+{
+    size_t offset = 0;
+    const size_t blocks = (size_t)_clauseNum * _blockNum;
+    auto carve = [&](size_t segmentBytes) -> char*
+    {
+        char *segment = (base == nullptr)? nullptr : base + offset;
+        offset = alignUp(offset + segmentBytes, _alignment);
+        return segment;
+    };
+    _positiveLiterals = reinterpret_cast<__m512i*>(carve(blocks * sizeof(__m512i)));
+    _negativeLiterals = reinterpret_cast<__m512i*>(carve(blocks * sizeof(__m512i)));
+    _posInclusion = reinterpret_cast<__mmask16*>(carve(blocks * sizeof(__mmask16)));
+    _negInclusion = reinterpret_cast<__mmask16*>(carve(blocks * sizeof(__mmask16)));
+    _literalMask = reinterpret_cast<__mmask16*>(carve(_blockNum * sizeof(__mmask16)));
+    _sInv = reinterpret_cast<double*>(carve(_clauseNum * sizeof(double)));
+    _sInvConj = reinterpret_cast<double*>(carve(_clauseNum * sizeof(double)));
+    _rngs = reinterpret_cast<pcg64_fast*>(carve(_clauseNum * sizeof(pcg64_fast)));
+    _votes = reinterpret_cast<int*>(carve(_clauseNum * sizeof(int)));
+    _dirty = reinterpret_cast<uint64_t*>(carve(dirtyWordNum() * sizeof(uint64_t)));
+    return offset;
+}
+
+void ClauseArena::allocate()
+{
+    _bytes = layout(nullptr);
+    if(_bytes == 0) return;
+    const size_t alignment = _hugePage? _hugePageSize : _alignment;
+    _base = static_cast<char*>(std::aligned_alloc(alignment, alignUp(_bytes, alignment)));
+    if(_base == nullptr)
+    {
+        std::cout<<"Cannot allocate "<<alignUp(_bytes, alignment)<<" bytes of clause arena."<<std::endl;
+        throw;
+    }
+#ifdef MADV_HUGEPAGE
+    if(_hugePage) madvise(_base, alignUp(_bytes, alignment), MADV_HUGEPAGE);
+#endif
+    layout(_base);
+}
+
+void ClauseArena::release()noexcept
+{
+    if(!_isBorrowed) std::free(_base);
+    _base = nullptr;
+    _isBorrowed = false;
+}
+
+/// @brief Bytes taken by the arena of given shape, e.g. to validate a mapped model file.
+/// @param args Shape of the arena.
+/// @return Total bytes of all segments.
+size_t ClauseArena::bytesFor(ArenaArgs args)noexcept
+{
+    ClauseArena probe;
+    probe._clauseNum = args.clauseNum;
+    probe._blockNum = args.inputSize/16 + (args.inputSize%16==0? 0:1);
+    size_t bytes = probe.layout(nullptr);
+    probe._clauseNum = probe._blockNum = 0;
+    return bytes;
+}
+
+/// @brief Recompute cached inclusion masks of a clause from its literal states.
+/// @param no Clause number.
+void ClauseArena::refreshInclusion(int no)noexcept
+{
+    const __m512i   zeros = _mm512_setzero_si512();
+    __m512i         *pos = positiveLiterals(no);
+    __m512i         *neg = negativeLiterals(no);
+    __mmask16       *posInc = posInclusion(no);
+    __mmask16       *negInc = negInclusion(no);
+    for (int i = 0; i < _blockNum; i++)
+    {
+        posInc[i] = _kand_mask16(_mm512_cmpge_epi32_mask(pos[i], zeros), _literalMask[i]);
+        negInc[i] = _kand_mask16(_mm512_cmpge_epi32_mask(neg[i], zeros), _literalMask[i]);
+    }
+}
+
+/// @brief Reseed feedback stream of every clause, so that a seeded machine trains reproducibly.
+/// @param seed Seed of the owning machine.
+/// @param stream Index telling arenas of one machine apart, e.g. automata number.
+void ClauseArena::seed(uint64_t seed, int stream)noexcept
+{
+    for (int no = 0; no < _clauseNum; no++)
+    {
+        std::seed_seq sequence{(uint32_t)seed, (uint32_t)(seed >> 32), (uint32_t)stream, (uint32_t)no};
+        _rngs[no].seed(sequence);
+    }
+}
+
+/// @brief Mark every block changed, e.g. after state is replaced as a whole.
+void ClauseArena::markAllDirty()noexcept
+{
+    std::fill(_dirty, _dirty + dirtyWordNum(), ~0ull);
+}
+
+/// @brief Forget changes, called once they are captured by a checkpoint.
+void ClauseArena::clearDirty()noexcept
+{
+    std::fill(_dirty, _dirty + dirtyWordNum(), 0ull);
+}
+
+/// @brief Add changes recorded by another arena of the same shape, e.g. a dropped snapshot.
+/// @param other Arena whose dirty blocks are merged.
+void ClauseArena::mergeDirty(const ClauseArena &other)noexcept
+{
+    for (size_t i = 0; i < dirtyWordNum(); i++) _dirty[i] |= other._dirty[i];
+}
+
+/// @return Literal block pairs changed since clearDirty.
+size_t ClauseArena::dirtyNum()const noexcept
+{
+    size_t result = 0;
+    for (size_t i = 0; i < dirtyWordNum(); i++) result += std::popcount(_dirty[i]);
+    return result;
+}
+
+/// @brief Restrict literals that clauses are allowed to include, e.g. feature subsampling.
+/// @param mask _blockNum masks of allowed literals.
+void ClauseArena::setLiteralMask(const __mmask16 *mask)noexcept
+{
+    for (int i = 0; i < _blockNum; i++)
+    {
+        _literalMask[i] = mask[i];
+    }
+    _literalMask[_blockNum - 1] = _kand_mask16(_literalMask[_blockNum - 1], _lastValidMask);
+    for (int no = 0; no < _clauseNum; no++)
+    {
+        refreshInclusion(no);
+    }
+}
+
+/// @brief Evaluate a clause against input masks without touching any state.
+/// @param no Clause number.
+/// @param in Input masks of the sample.
+/// @param inverse Complement of input masks within valid literals.
+/// @return Whether all included literals are satisfied.
+bool ClauseArena::evaluate( int no,
+                            const __mmask16 *in,
+                            const __mmask16 *inverse)const noexcept
+{
+    const __mmask16 *posInc = posInclusion(no);
+    const __mmask16 *negInc = negInclusion(no);
+    for (int i = 0; i < _blockNum; i++)
+    {
+        __mmask16 posWrong = _kand_mask16(posInc[i], inverse[i]);  // Included but input=0, positive literal wrong.
+        __mmask16 negWrong = _kand_mask16(negInc[i], in[i]);       // Included but input=1, negative literal wrong.
+        if(_mm512_mask2int(_kor_mask16(posWrong, negWrong)) != 0)[[likely]] return false;
+    }
+    return true;
+}
+
+/// @brief Convert one packed sample into input masks shared by all clauses.
+/// @param in Packed sample of _blockNum blocks.
+/// @param mask Output mask of literals that equal to one.
+/// @param inverse Output mask of valid literals that equal to zero.
+void ClauseArena::maskInput(const __m512i *in,
+                            __mmask16 *mask,
+                            __mmask16 *inverse)const noexcept
+{
+    const __m512i zeros = _mm512_setzero_si512();
+    for (int i = 0; i < _blockNum; i++)
+    {
+        mask[i] = _mm512_cmpgt_epi32_mask(in[i], zeros);    // Greater than zero (only possible value is one)
+        inverse[i] = _knot_mask16(mask[i]);
+    }
+    inverse[_blockNum - 1] = _kand_mask16(inverse[_blockNum - 1], _lastValidMask);
+}
@@ -0,0 +1,137 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include "pcg_random.hpp"
+using std::vector;
+
+/// @brief Contiguous storage of all clauses' state of one automata.
+///        Every member is a struct-of-arrays segment indexed by clause number,
+///        all segments live in one 64-byte aligned allocation.
+class ClauseArena{
+public:
+    struct ArenaArgs
+    {
+        int     clauseNum;          // Total clauses, including both polarities.
+        int     inputSize;
+        bool    hugePage;           // Advise kernel to back the arena with transparent huge pages.
+        char    *mapped = nullptr;  // Borrow state laid out by layout(), e.g. from a mapped model file.
+    };
+
+private:
+    static constexpr size_t         _alignment = 64;
+    static constexpr size_t         _hugePageSize = 2 * 1024 * 1024;
+
+    int                     _clauseNum;
+    int                     _literalNum;
+    int                     _blockNum;
+    bool                    _hugePage;
+    bool                    _isBorrowed;        // _base belongs to someone else, never freed here.
+    __mmask16               _lastValidMask;     // Boundary problem
+
+    size_t                  _bytes;
+    char                    *_base;
+
+    ////////////////////// Segments inside _base //////////////////////
+    __m512i                 *_positiveLiterals; // _clauseNum * _blockNum
+    __m512i                 *_negativeLiterals;
+    __mmask16               *_posInclusion;     // Cached inclusion, refreshed after every feedback.
+    __mmask16               *_negInclusion;
+    __mmask16               *_literalMask;      // _blockNum, literals allowed to be included.
+    double                  *_sInv;             // Per clause granular, possibility of 1/s.
+    double                  *_sInvConj;
+    pcg64_fast              *_rngs;
+    int                     *_votes;
+    uint64_t                *_dirty;            // One bit per literal block pair changed since clearDirty.
+    ////////////////////// Segments inside _base //////////////////////
+
+    size_t  layout(char *base)noexcept;
+    void    allocate();
+    void    release()noexcept;
+
+public:
+    ClauseArena()noexcept;
+    ClauseArena(ArenaArgs args);
+    ClauseArena(const ClauseArena &other);
+    ClauseArena(ClauseArena &&other)noexcept;
+    ClauseArena& operator=(const ClauseArena &other);
+    ClauseArena& operator=(ClauseArena &&other)noexcept;
+    ~ClauseArena();
+
+    static size_t   bytesFor(ArenaArgs args)noexcept;
+
+    void        refreshInclusion(int no)noexcept;
+    void        seed(uint64_t seed, int stream)noexcept;
+    void        markAllDirty()noexcept;
+    void        clearDirty()noexcept;
+    void        mergeDirty(const ClauseArena &other)noexcept;
+    size_t      dirtyNum()const noexcept;
+    void        setLiteralMask(const __mmask16 *mask)noexcept;
+    bool        evaluate(   int no,
+                            const __mmask16 *in,
+                            const __mmask16 *inverse)const noexcept;
+    void        maskInput(  const __m512i *in,
+                            __mmask16 *mask,
+                            __mmask16 *inverse)const noexcept;
+
+    int         clauseNum()const noexcept       {return _clauseNum;}
+    int         literalNum()const noexcept      {return _literalNum;}
+    int         blockNum()const noexcept        {return _blockNum;}
+    __mmask16   lastValidMask()const noexcept   {return _lastValidMask;}
+    const __mmask16*    literalMask()const noexcept     {return _literalMask;}
+
+    __m512i*    positiveLiterals(int no)noexcept    {return _positiveLiterals + (size_t)no * _blockNum;}
+    __m512i*    negativeLiterals(int no)noexcept    {return _negativeLiterals + (size_t)no * _blockNum;}
+    __mmask16*  posInclusion(int no)noexcept        {return _posInclusion + (size_t)no * _blockNum;}
+    __mmask16*  negInclusion(int no)noexcept        {return _negInclusion + (size_t)no * _blockNum;}
+    double&     sInv(int no)noexcept                {return _sInv[no];}
+    double&     sInvConj(int no)noexcept            {return _sInvConj[no];}
+    pcg64_fast& rng(int no)noexcept                 {return _rngs[no];}
+    int&        vote(int no)noexcept                {return _votes[no];}
+    void        markDirty(int no, int block)noexcept
+    {
+        size_t bit = (size_t)no * _blockNum + block;
+        _dirty[bit >> 6] |= 1ull << (bit & 63);
+    }
+    bool        isDirty(int no, int block)const noexcept
+    {
+        size_t bit = (size_t)no * _blockNum + block;
+        return (_dirty[bit >> 6] >> (bit & 63)) & 1;
+    }
+
+    const __m512i*      positiveLiterals(int no)const noexcept  {return _positiveLiterals + (size_t)no * _blockNum;}
+    const __m512i*      negativeLiterals(int no)const noexcept  {return _negativeLiterals + (size_t)no * _blockNum;}
+    const __mmask16*    posInclusion(int no)const noexcept      {return _posInclusion + (size_t)no * _blockNum;}
+    const __mmask16*    negInclusion(int no)const noexcept      {return _negInclusion + (size_t)no * _blockNum;}
+
+    const char* data()const noexcept    {return _base;}
+    char*       data()noexcept          {return _base;}
+    size_t      tailOffset()const noexcept  {return (const char*)_posInclusion - _base;}  // State after literal blocks.
+    size_t      dirtyWordNum()const noexcept    {return ((size_t)_clauseNum * _blockNum + 63) / 64;}
+    bool        isBorrowed()const noexcept  {return _isBorrowed;}
+    size_t      bytes()const noexcept   {return _bytes;}
+};
@@ -0,0 +1,261 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "CoalescedTsetlinMachine.h"
+#include <numeric>
+#include <algorithm>
+
+CoalescedTsetlinMachine::CoalescedTsetlinMachine(MachineArgs args, vector<string> tierTags)noexcept:
+_inputSize(args.inputSize),
+_outputSize(args.outputSize),
+_clauseNum(args.clauseNum),
+_clauseBlockNum(args.clauseNum/16 + (args.clauseNum%16==0? 0:1)),
+_T(args.T),
+_dropoutRatio(args.dropoutRatio),
+_myArgs(args),
+_tierTags(tierTags),
+_clauses(ClauseArena::ArenaArgs{args.clauseNum, args.inputSize, args.hugePage})
+{
+    if(args.seed != 0)
+    {
+        std::seed_seq sequence{(uint32_t)args.seed, (uint32_t)(args.seed >> 32)};  // A raw seed loses its low bits in pcg64_fast.
+        _rng.seed(sequence);
+    }
+    else
+    {
+        pcg_extras::seed_seq_from<std::random_device> seed_source;
+        _rng.seed(seed_source);
+    }
+
+    for (int i = 0; i < _clauseNum; i++)
+    {
+        Clause(_clauses, i).initialize(args.sLow + i * (args.sHigh - args.sLow)/((double)_clauseNum));
+    }
+
+    std::bernoulli_distribution sign(0.5);
+    _weights.resize((size_t)_outputSize * _clauseBlockNum * 16, 0);   // Padded clauses keep zero weight.
+    for (int output = 0; output < _outputSize; output++)
+    {
+        for (int i = 0; i < _clauseNum; i++)
+        {
+            weightRow(output)[i] = sign(_rng)? 1 : -1;
+        }
+    }
+    _clauseOutputs.resize(_clauseBlockNum, 0);
+    _classSums.resize(_outputSize, 0);
+    _inputMask.resize(_clauses.blockNum(), 0);
+    _inputMaskInverse.resize(_clauses.blockNum(), 0);
+}
+
+/// @brief Check the integrity of argument 'data'.
+/// @param data Input unknown size 2D vector.
+/// @return Result of integrity check procedure.
+bool
+CoalescedTsetlinMachine::dataIntegrityCheck(const vector<vector<int>> &data)
+{
+    bool isZeroSize = (data.size()==0);
+    bool isCorrectLength = true;
+    for (int i = 0; i < data.size(); i++)
+    {
+        isCorrectLength &= (data[i].size() == _inputSize);
+        if(!isCorrectLength)break;
+    }
+    bool result = (!isZeroSize) && (isCorrectLength);
+    if (!result)
+    {
+        std::cout<<"Data failed integrity check."<<std::endl;
+    }
+    return result;
+}
+
+/// @brief Convert one-hot response row to class index.
+/// @param oneHot Response row shaped in ( 1, _outputSize ).
+/// @return Index of the hot digit, -1 when the row is not exactly one-hot.
+int
+CoalescedTsetlinMachine::labelOf(const vector<int> &oneHot)
+{
+    return TsetlinMachine::hotIndex(oneHot);
+}
+
+/// @brief Evaluate every clause of the pool once, then get all class sums from weight rows.
+/// @param datavec A single packed sample.
+void
+CoalescedTsetlinMachine::forward(const __m512i *datavec)noexcept
+{
+    _clauses.maskInput(datavec, _inputMask.data(), _inputMaskInverse.data());
+    std::fill(_clauseOutputs.begin(), _clauseOutputs.end(), 0);
+    for (int i = 0; i < _clauseNum; i++)
+    {
+        int vote = Clause(_clauses, i).vote(_inputMask.data(), _inputMaskInverse.data());
+        _clauseOutputs[i/16] |= (vote << (i%16));
+    }
+    for (int output = 0; output < _outputSize; output++)
+    {
+        const int   *row = weightRow(output);
+        __m512i     acc = _mm512_setzero_si512();
+        for (int b = 0; b < _clauseBlockNum; b++)
+        {
+            acc = _mm512_mask_add_epi32(acc, _clauseOutputs[b], acc, _mm512_loadu_si512(row + b*16));
+        }
+        _classSums[output] = _mm512_reduce_add_epi32(acc);
+    }
+}
+
+/// @brief Give feedback to the whole pool on behalf of one output.
+/// @param output Index of output whose weight row is updated.
+/// @param probability Possibility of each clause receiving feedback.
+/// @param isTarget Whether this output is the target of current sample.
+void
+CoalescedTsetlinMachine::feedback(int output, double probability, bool isTarget)noexcept
+{
+    std::uniform_real_distribution<double> d(0.0, 1.0);
+    int *row = weightRow(output);
+    for (int i = 0; i < _clauseNum; i++)
+    {
+        if(d(_rng) >= probability) continue;
+        if(d(_rng) < _dropoutRatio) continue;       // Random dropout some clauses.
+        Clause  clause(_clauses, i);
+        bool    isFired = (_clauseOutputs[i/16] >> (i%16)) & 1;
+        bool    isSupporter = (row[i] >= 0);
+        if(isSupporter == isTarget)
+        {
+            clause.feedbackTypeI(_inputMask.data(), _inputMaskInverse.data());
+        }
+        else
+        {
+            clause.feedbackTypeII(_inputMask.data(), _inputMaskInverse.data());
+        }
+        if(isFired) row[i] += (isTarget? 1 : -1);
+    }
+}
+
+/// @brief Update target output and one randomly sampled non-target output.
+/// @param target Class index of current sample.
+void
+CoalescedTsetlinMachine::backward(int target)noexcept
+{
+    double rescaleFactor = 1.0f / static_cast<double>(2 * _T);
+    int clampedSum = std::min(_T, std::max(-_T, _classSums[target]));
+    feedback(target, (_T - clampedSum) * rescaleFactor, true);
+
+    if(_outputSize < 2) return;
+    std::uniform_int_distribution<int> pick(0, _outputSize - 2);
+    int negative = pick(_rng);
+    negative += (negative >= target);
+    clampedSum = std::min(_T, std::max(-_T, _classSums[negative]));
+    feedback(negative, (_T + clampedSum) * rescaleFactor, false);
+}
+
+/// @brief Perform data integrity check and load into shared vector.
+/// @param data 2D vector shaped in ( sampleNum * _inputSize )
+/// @param response 2D vector shaped in ( sampleNum * _outputSize )
+void
+CoalescedTsetlinMachine::load(  vector<vector<int>> &data,
+                                vector<vector<int>> &response)
+{
+    bool isRightResponse = (response.size() == data.size()) &&
+                           (response.size() > 0) &&
+                           (response[0].size() == _outputSize);
+    for (int i = 0; i < response.size() && isRightResponse; i++)
+    {
+        isRightResponse &= (response[i].size() == _outputSize) && (labelOf(response[i]) >= 0);
+    }
+    if(!isRightResponse) std::cout<<"Response failed integrity check."<<std::endl;
+    if(!dataIntegrityCheck(data) || !isRightResponse) {throw;return;}
+
+    _sharedData.resize(data.size(), _inputSize);
+    _labels.resize(data.size());
+    for (int i = 0; i < data.size(); i++)
+    {
+        _sharedData.packRow(i, data[i].data());
+        _labels[i] = labelOf(response[i]);
+    }
+    _sampleOrder.resize(data.size());
+    std::iota(_sampleOrder.begin(), _sampleOrder.end(), 0);
+}
+
+/// @brief Train this Tsetlin machine using loaded data.
+/// @param epoch Max count of repeat training time.
+void
+CoalescedTsetlinMachine::train(int epoch)
+{
+    const int sampleNum = _sampleOrder.size();
+    for (int e = 0; e < epoch; e++)
+    {
+        if(_myArgs.shuffle) std::shuffle(_sampleOrder.begin(), _sampleOrder.end(), _rng);
+        for (int i = 0; i < sampleNum; i++)
+        {
+            if(i + 1 < sampleNum)[[likely]]        // Hide latency of random access to next sample.
+            {
+                const __m512i *next = _sharedData[_sampleOrder[i + 1]];
+                for (int b = 0; b < _sharedData.stride(); b++)
+                {
+                    _mm_prefetch((const char*)&next[b], _MM_HINT_T0);
+                }
+            }
+            int idx = _sampleOrder[i];
+            forward(_sharedData[idx]);
+            backward(_labels[idx]);
+        }
+    }
+}
+
+/// @brief Load data and predict response using trained tsetlin machine.
+/// @param data 2D vector shaped in ( sampleNum * _inputSize )
+/// @return 2D vector shaped in ( sampleNum * _outputSize )
+vector<vector<int>>
+CoalescedTsetlinMachine::loadAndPredict(vector<vector<int>> &data)
+{
+    if( !dataIntegrityCheck(data)) throw;
+    vector<vector<int>> result(data.size(), vector<int>(_outputSize,0));
+    PackedData          packed(1, _inputSize);      // Scratch row reused by every sample.
+    for (int sampleIdx = 0; sampleIdx < data.size(); sampleIdx++)
+    {
+        packed.packRow(0, data[sampleIdx].data());
+        forward(packed[0]);
+        int competitorIdx = TsetlinMachine::argmax(_classSums.data(), _outputSize);
+        result[sampleIdx][competitorIdx] = 1;
+    }
+    return result;
+}
+
+/// @brief Export current model.
+/// @return Current clause pool, weight matrix and arguments.
+CoalescedTsetlinMachine::model
+CoalescedTsetlinMachine::exportModel()
+{
+    model result;
+    result.modelArgs = _myArgs;
+    result.tierTags = _tierTags;
+    result.clauses.resize(_clauseNum);
+    for (int i = 0; i < _clauseNum; i++)
+    {
+        result.clauses[i] = Clause(_clauses, i).exportModel();
+    }
+    result.weights.resize(_outputSize);
+    for (int output = 0; output < _outputSize; output++)
+    {
+        result.weights[output].assign(weightRow(output), weightRow(output) + _clauseNum);
+    }
+    return result;
+}
@@ -0,0 +1,95 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include "TsetlinMachine.h"
+using std::vector;
+using std::string;
+
+/// @brief Coalesced Tsetlin machine, all outputs share one clause pool and
+///        each output owns a row of signed clause weights.
+class CoalescedTsetlinMachine{
+public:
+    struct MachineArgs
+    {
+        int             inputSize;
+        int             outputSize;
+        int             clauseNum;          // Size of the shared pool, not per output.
+        int             T;
+        double          sLow, sHigh;
+        double          dropoutRatio;
+        bool            shuffle = true;     // Visit samples in a fresh random order every epoch.
+        uint64_t        seed = 0;           // Seed of shuffling and weight stream, 0 means seeded from random device.
+        bool            hugePage = false;   // Back clause arena with transparent huge pages.
+    };
+    struct model
+    {
+        MachineArgs             modelArgs;
+        vector<string>          tierTags;
+        vector<vector<int>>     clauses;    // Arranged in size of clauseNum * (literalNum * 2)
+        vector<vector<int>>     weights;    // Arranged in size of outputSize * clauseNum
+        model(){}
+    };
+
+private:
+    const int                   _inputSize;
+    const int                   _outputSize;
+    const int                   _clauseNum;
+    const int                   _clauseBlockNum;    // Clauses grouped by 16, one bit of vote each.
+    const int                   _T;
+    const double                _dropoutRatio;
+    const MachineArgs           _myArgs;
+    const vector<string>        _tierTags;
+
+    ClauseArena                 _clauses;
+    vector<int>                 _weights;           // _outputSize rows, each padded to _clauseBlockNum * 16.
+    vector<__mmask16>           _clauseOutputs;     // Votes of current sample.
+    vector<int>                 _classSums;
+    vector<__mmask16>           _inputMask;
+    vector<__mmask16>           _inputMaskInverse;
+
+    PackedData                  _sharedData;        // One aligned slab of all loaded samples.
+    vector<int>                 _labels;
+    vector<int>                 _sampleOrder;
+    pcg64_fast                  _rng;
+
+    bool    dataIntegrityCheck(const vector<vector<int>> &data);
+    int     labelOf(const vector<int> &oneHot);
+    int*    weightRow(int output)noexcept   {return _weights.data() + (size_t)output * _clauseBlockNum * 16;}
+
+    void    forward(const __m512i *datavec)noexcept;
+    void    backward(int target)noexcept;
+    void    feedback(int output, double probability, bool isTarget)noexcept;
+
+public:
+    CoalescedTsetlinMachine(MachineArgs args, vector<string> tierTags)noexcept;
+
+    void                load(   vector<vector<int>> &data,
+                                vector<vector<int>> &response);
+    void                train(int epoch);
+
+    vector<vector<int>> loadAndPredict(vector<vector<int>> &data);
+
+    model               exportModel();
+    const vector<int>&  paddedWeights()const noexcept   {return _weights;}  // Rows of _clauseBlockNum * 16, padding stays zero.
+};
@@ -0,0 +1,128 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "CompactMachine.h"
+#include "TsetlinMachine.h"
+#include <algorithm>
+
+CompactMachine::CompactMachine(CompactArgs args)noexcept:
+_originalInputSize(args.originalInputSize),
+_inputSize(args.inputRemap.size()),
+_outputSize(args.outputSize),
+_clauseNum(args.positiveIncludes.size()),
+_wordNum(std::max<int>(1, (args.inputRemap.size() + 63)/64)),
+_inputRemap(args.inputRemap),
+_tierTags(args.tierTags)
+{
+    _positiveMasks.resize((size_t)_clauseNum * _wordNum, 0);
+    _negativeMasks.resize((size_t)_clauseNum * _wordNum, 0);
+    for (int i = 0; i < _clauseNum; i++)
+    {
+        for(int literal : args.positiveIncludes[i])
+        {
+            _positiveMasks[(size_t)i * _wordNum + literal/64] |= (1ULL << (literal%64));
+        }
+        for(int literal : args.negativeIncludes[i])
+        {
+            _negativeMasks[(size_t)i * _wordNum + literal/64] |= (1ULL << (literal%64));
+        }
+    }
+    _weights.resize((size_t)_outputSize * _clauseNum, 0);
+    for (int output = 0; output < _outputSize; output++)
+    {
+        for (int i = 0; i < _clauseNum; i++)
+        {
+            _weights[(size_t)output * _clauseNum + i] = args.weights[output][i];
+        }
+    }
+}
+
+/// @brief Check the integrity of argument 'data'.
+/// @param data Input unknown size 2D vector, each row in original input width.
+/// @return Result of integrity check procedure.
+bool
+CompactMachine::dataIntegrityCheck(const vector<vector<int>> &data)
+{
+    bool isZeroSize = (data.size()==0);
+    bool isCorrectLength = true;
+    for (int i = 0; i < data.size(); i++)
+    {
+        isCorrectLength &= (data[i].size() == _originalInputSize);
+        if(!isCorrectLength)break;
+    }
+    bool result = (!isZeroSize) && (isCorrectLength);
+    if (!result)
+    {
+        std::cout<<"Data failed integrity check."<<std::endl;
+    }
+    return result;
+}
+
+/// @brief Classify one sample that is already reduced to kept literals.
+/// @param reducedSample Bit-packed kept literals, wordsPerSample() words.
+/// @param sums Output class sums, _outputSize elements.
+/// @return Index of winning output, following the rule of TsetlinMachine.
+int
+CompactMachine::predict(const uint64_t *reducedSample, int *sums)const noexcept
+{
+    for (int output = 0; output < _outputSize; output++) sums[output] = 0;
+    for (int i = 0; i < _clauseNum; i++)
+    {
+        const uint64_t  *pos = &_positiveMasks[(size_t)i * _wordNum];
+        const uint64_t  *neg = &_negativeMasks[(size_t)i * _wordNum];
+        uint64_t        wrong = 0;
+        for (int w = 0; w < _wordNum; w++)
+        {
+            wrong |= (pos[w] & ~reducedSample[w]) | (neg[w] & reducedSample[w]);
+        }
+        if(wrong != 0) continue;
+        for (int output = 0; output < _outputSize; output++)
+        {
+            sums[output] += _weights[(size_t)output * _clauseNum + i];
+        }
+    }
+    return TsetlinMachine::argmax(sums, _outputSize);
+}
+
+/// @brief Reduce data to kept literals and predict response.
+/// @param data 2D vector shaped in ( sampleNum * originalInputSize )
+/// @return 2D vector shaped in ( sampleNum * _outputSize )
+vector<vector<int>>
+CompactMachine::loadAndPredict(vector<vector<int>> &data)
+{
+    if( !dataIntegrityCheck(data)) throw;
+    vector<vector<int>> result(data.size(), vector<int>(_outputSize,0));
+    vector<uint64_t>    reduced(_wordNum, 0);
+    vector<int>         sums(_outputSize, 0);
+    for (int sampleIdx = 0; sampleIdx < data.size(); sampleIdx++)
+    {
+        std::fill(reduced.begin(), reduced.end(), 0);
+        for (int literal = 0; literal < _inputSize; literal++)
+        {
+            uint64_t bit = (data[sampleIdx][_inputRemap[literal]] > 0);
+            reduced[literal/64] |= (bit << (literal%64));
+        }
+        result[sampleIdx][predict(reduced.data(), sums.data())] = 1;
+    }
+    return result;
+}
@@ -0,0 +1,73 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <iostream>
+using std::vector;
+using std::string;
+
+/// @brief Lean inference-only model produced by TsetlinMachine::compact().
+///        Unique clauses are kept once with a signed weight per output,
+///        and only literals included by some clause are kept as input.
+class CompactMachine{
+public:
+    struct CompactArgs
+    {
+        int                     originalInputSize;
+        int                     outputSize;
+        vector<int>             inputRemap;     // Original column of each kept literal.
+        vector<vector<int>>     positiveIncludes;   // Kept literal indices included by each clause.
+        vector<vector<int>>     negativeIncludes;
+        vector<vector<int>>     weights;        // Arranged in size of outputSize * clauseNum
+        vector<string>          tierTags;
+    };
+
+private:
+    const int                   _originalInputSize;
+    const int                   _inputSize;     // Number of kept literals.
+    const int                   _outputSize;
+    const int                   _clauseNum;
+    const int                   _wordNum;       // 64 literals per word.
+    const vector<int>           _inputRemap;
+    const vector<string>        _tierTags;
+
+    vector<uint64_t>            _positiveMasks; // _clauseNum * _wordNum
+    vector<uint64_t>            _negativeMasks;
+    vector<int>                 _weights;       // _outputSize * _clauseNum
+
+    bool    dataIntegrityCheck(const vector<vector<int>> &data);
+
+public:
+    CompactMachine(CompactArgs args)noexcept;
+
+    vector<vector<int>> loadAndPredict(vector<vector<int>> &data);
+    int                 predict(const uint64_t *reducedSample, int *sums)const noexcept;
+
+    int                 inputSize()const noexcept           {return _inputSize;}
+    int                 clauseNum()const noexcept           {return _clauseNum;}
+    int                 wordsPerSample()const noexcept      {return _wordNum;}
+    const vector<int>&  inputRemap()const noexcept          {return _inputRemap;}
+};
@@ -0,0 +1,352 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "ConvolutionalTsetlinMachine.h"
+#include <numeric>
+#include <algorithm>
+
+ConvolutionalTsetlinMachine::ConvolutionalTsetlinMachine(MachineArgs args, vector<string> tierTags)noexcept:
+_inputSize(args.sequenceLength * args.symbolWidth + args.extraSize),
+_outputSize(args.outputSize),
+_clausePerOutput(args.clausePerOutput),
+_T(args.T),
+_dropoutRatio(args.dropoutRatio),
+_windowBits(args.windowSize * args.symbolWidth),
+_positionBits(args.positionLiterals? args.sequenceLength - args.windowSize : 0),
+_patchNum(args.sequenceLength - args.windowSize + 1),
+_patchSize(_windowBits + _positionBits + args.extraSize),
+_sampleWordNum(_inputSize/64 + 2),
+_patchWordNum(_patchSize/64 + 2),
+_myArgs(args),
+_tierTags(tierTags)
+{
+    if(args.seed != 0)
+    {
+        std::seed_seq sequence{(uint32_t)args.seed, (uint32_t)(args.seed >> 32)};  // A raw seed loses its low bits in pcg64_fast.
+        _rng.seed(sequence);
+    }
+    else
+    {
+        pcg_extras::seed_seq_from<std::random_device> seed_source;
+        _rng.seed(seed_source);
+    }
+
+    for (int j = 0; j < _outputSize; j++)
+    {
+        _arenas.emplace_back(ClauseArena::ArenaArgs{2 * _clausePerOutput, _patchSize, args.hugePage});
+        for (int i = 0; i < _clausePerOutput; i++)
+        {
+            double specificity = args.sLow + i * (args.sHigh - args.sLow)/((double)_clausePerOutput);
+            Clause(_arenas[j], i).initialize(specificity);
+            Clause(_arenas[j], i + _clausePerOutput).initialize(specificity);
+        }
+    }
+    _blockNum = _arenas[0].blockNum();
+
+    _positionTemplate.resize((size_t)_patchNum * _patchWordNum, 0);
+    for (int p = 0; p < _patchNum; p++)     // Window at position p sets its first p position literals.
+    {
+        for (int t = 0; t < std::min(p, _positionBits); t++)
+        {
+            const int bit = _windowBits + t;
+            _positionTemplate[(size_t)p * _patchWordNum + bit/64] |= (uint64_t)1 << (bit%64);
+        }
+    }
+    _patchWords.resize((size_t)_patchNum * _patchWordNum, 0);
+    _patchMask.resize((size_t)_patchNum * _blockNum, 0);
+    _patchMaskInverse.resize((size_t)_patchNum * _blockNum, 0);
+    _firedPatch.resize(2 * _clausePerOutput, -1);
+    _candidates.reserve(_patchNum);
+}
+
+/// @brief Check the integrity of argument 'data'.
+/// @param data Input unknown size 2D vector.
+/// @return Result of integrity check procedure.
+bool
+ConvolutionalTsetlinMachine::dataIntegrityCheck(const vector<vector<int>> &data)
+{
+    bool isZeroSize = (data.size()==0);
+    bool isCorrectLength = true;
+    for (int i = 0; i < data.size(); i++)
+    {
+        isCorrectLength &= (data[i].size() == _inputSize);
+        if(!isCorrectLength)break;
+    }
+    bool result = (!isZeroSize) && (isCorrectLength);
+    if (!result)
+    {
+        std::cout<<"Data failed integrity check."<<std::endl;
+    }
+    return result;
+}
+
+/// @brief Convert one-hot response row to class index.
+/// @param oneHot Response row shaped in ( 1, _outputSize ).
+/// @return Index of the hot digit, -1 when the row is not exactly one-hot.
+int
+ConvolutionalTsetlinMachine::labelOf(const vector<int> &oneHot)
+{
+    return TsetlinMachine::hotIndex(oneHot);
+}
+
+/// @brief Pack a 0/1 vector into 64-bit words, lowest bit first.
+/// @param original Sample shaped in ( 1, _inputSize ).
+/// @param target Destination of _sampleWordNum words.
+void
+ConvolutionalTsetlinMachine::packBits(const vector<int> &original, uint64_t *target)noexcept
+{
+    std::fill(target, target + _sampleWordNum, 0);
+    for (int i = 0; i < _inputSize; i++)
+    {
+        target[i/64] |= (uint64_t)(original[i] > 0) << (i%64);
+    }
+}
+
+/// @brief Read 64 bits starting at an arbitrary bit offset, source must be padded by one word.
+/// @param src Bit-packed words.
+/// @param offset Offset in bits.
+/// @return Bits [offset, offset + 64).
+uint64_t
+ConvolutionalTsetlinMachine::readBits(const uint64_t *src, size_t offset)noexcept
+{
+    const size_t    word = offset / 64;
+    const int       shift = offset % 64;
+    uint64_t        bits = src[word] >> shift;
+    if(shift != 0) bits |= src[word + 1] << (64 - shift);
+    return bits;
+}
+
+/// @brief OR a run of bits into destination with word-wide shifts, destination must be padded by one word.
+/// @param src Bit-packed source words.
+/// @param srcOffset Offset of the run in source, in bits.
+/// @param length Length of the run in bits.
+/// @param dst Bit-packed destination words.
+/// @param dstOffset Offset of the run in destination, in bits.
+void
+ConvolutionalTsetlinMachine::copyBits(  const uint64_t *src, size_t srcOffset, int length,
+                                        uint64_t *dst, size_t dstOffset)noexcept
+{
+    for (int done = 0; done < length; done += 64)
+    {
+        const int   width = std::min(64, length - done);
+        uint64_t    bits = readBits(src, srcOffset + done);
+        if(width < 64) bits &= ((uint64_t)1 << width) - 1;
+        const size_t    word = (dstOffset + done) / 64;
+        const int       shift = (dstOffset + done) % 64;
+        dst[word] |= bits << shift;
+        if(shift != 0) dst[word + 1] |= bits >> (64 - shift);
+    }
+}
+
+/// @brief Cut every window out of a bit-packed sample and convert them to input masks.
+/// @param sample Bit-packed sample of _sampleWordNum words.
+void
+ConvolutionalTsetlinMachine::buildPatches(const uint64_t *sample)noexcept
+{
+    const int       symbolWidth = _myArgs.symbolWidth;
+    const int       sequenceBits = _myArgs.sequenceLength * symbolWidth;
+    const __mmask16 lastValidMask = _arenas[0].lastValidMask();
+    std::copy(_positionTemplate.begin(), _positionTemplate.end(), _patchWords.begin());
+    for (int p = 0; p < _patchNum; p++)
+    {
+        uint64_t    *words = &_patchWords[(size_t)p * _patchWordNum];
+        copyBits(sample, (size_t)p * symbolWidth, _windowBits, words, 0);
+        copyBits(sample, sequenceBits, _myArgs.extraSize, words, _windowBits + _positionBits);
+
+        __mmask16   *mask = &_patchMask[(size_t)p * _blockNum];
+        __mmask16   *inverse = &_patchMaskInverse[(size_t)p * _blockNum];
+        for (int i = 0; i < _blockNum; i++)
+        {
+            mask[i] = (__mmask16)(words[i/4] >> (16 * (i%4)));
+            inverse[i] = _knot_mask16(mask[i]);
+        }
+        inverse[_blockNum - 1] = _kand_mask16(inverse[_blockNum - 1], lastValidMask);
+    }
+}
+
+/// @brief Vote of one clause, i.e. OR of its evaluation over all windows.
+/// @param output Index of output owning the clause.
+/// @param no Clause number inside the arena of output.
+/// @param isTraining Whether to pick a random fired window for feedback instead of exiting early.
+/// @return Vote result, 0 or 1.
+int
+ConvolutionalTsetlinMachine::vote(int output, int no, bool isTraining)noexcept
+{
+    ClauseArena &arena = _arenas[output];
+    _candidates.clear();
+    for (int p = 0; p < _patchNum; p++)
+    {
+        if(arena.evaluate(no, &_patchMask[(size_t)p * _blockNum], &_patchMaskInverse[(size_t)p * _blockNum]))
+        {
+            _candidates.push_back(p);
+            if(!isTraining) break;
+        }
+    }
+    int result = _candidates.empty()? 0:1;
+    arena.vote(no) = result;
+    if(isTraining)
+    {
+        _firedPatch[no] = -1;
+        if(result)
+        {
+            std::uniform_int_distribution<int> pick(0, _candidates.size() - 1);
+            _firedPatch[no] = _candidates[pick(_rng)];
+        }
+    }
+    return result;
+}
+
+/// @brief Class sum of one output on current windows.
+/// @param output Index of output.
+/// @param isTraining Whether fired windows are recorded for feedback.
+/// @return Votes of positive clauses minus votes of negative clauses.
+int
+ConvolutionalTsetlinMachine::forward(int output, bool isTraining)noexcept
+{
+    int sum = 0;
+    for (int i = 0; i < _clausePerOutput; i++)
+    {
+        sum += vote(output, i, isTraining);
+        sum -= vote(output, i + _clausePerOutput, isTraining);
+    }
+    return sum;
+}
+
+/// @brief Feedback of one output, fired clauses learn from the window they were chosen on.
+/// @param output Index of output.
+/// @param response Target response of this output, 0 or 1.
+/// @param classSum Class sum given by forward.
+void
+ConvolutionalTsetlinMachine::backward(int output, int response, int classSum)noexcept
+{
+    std::uniform_real_distribution<double> d(0.0, 1.0);
+    const int       clampedSum = std::min(_T, std::max(-_T, classSum));
+    const double    probability = (response == 1)?  (_T - clampedSum) / (2.0 * _T) :
+                                                    (_T + clampedSum) / (2.0 * _T);
+    for (int i = 0; i < _clausePerOutput; i++)
+    {
+        if(d(_rng) >= probability) continue;
+        if(d(_rng) < _dropoutRatio) continue;       // Random dropout some clauses.
+        const int   typeI = (response == 1)? i : i + _clausePerOutput;
+        const int   typeII = (response == 1)? i + _clausePerOutput : i;
+        const int   patchI = std::max(0, _firedPatch[typeI]);    // Window is irrelevant when clause is not fired.
+        Clause(_arenas[output], typeI).feedbackTypeI(   &_patchMask[(size_t)patchI * _blockNum],
+                                                        &_patchMaskInverse[(size_t)patchI * _blockNum]);
+        if(_firedPatch[typeII] >= 0)
+        {
+            const int patchII = _firedPatch[typeII];
+            Clause(_arenas[output], typeII).feedbackTypeII( &_patchMask[(size_t)patchII * _blockNum],
+                                                            &_patchMaskInverse[(size_t)patchII * _blockNum]);
+        }
+    }
+}
+
+/// @brief Perform data integrity check and load into shared bit-packed storage.
+/// @param data 2D vector shaped in ( sampleNum * _inputSize )
+/// @param response 2D vector shaped in ( sampleNum * _outputSize )
+void
+ConvolutionalTsetlinMachine::load(  vector<vector<int>> &data,
+                                    vector<vector<int>> &response)
+{
+    bool isRightResponse = (response.size() == data.size()) &&
+                           (response.size() > 0) &&
+                           (response[0].size() == _outputSize);
+    for (int i = 0; i < response.size() && isRightResponse; i++)
+    {
+        isRightResponse &= (response[i].size() == _outputSize) && (labelOf(response[i]) >= 0);
+    }
+    if(!isRightResponse) std::cout<<"Response failed integrity check."<<std::endl;
+    if(!dataIntegrityCheck(data) || !isRightResponse) {throw;return;}
+
+    _sharedData.assign(data.size() * _sampleWordNum, 0);
+    _labels.resize(data.size());
+    for (int i = 0; i < data.size(); i++)
+    {
+        packBits(data[i], &_sharedData[(size_t)i * _sampleWordNum]);
+        _labels[i] = labelOf(response[i]);
+    }
+    _sampleOrder.resize(data.size());
+    std::iota(_sampleOrder.begin(), _sampleOrder.end(), 0);
+}
+
+/// @brief Train this Tsetlin machine using loaded data.
+/// @param epoch Max count of repeat training time.
+void
+ConvolutionalTsetlinMachine::train(int epoch)
+{
+    for (int e = 0; e < epoch; e++)
+    {
+        if(_myArgs.shuffle) std::shuffle(_sampleOrder.begin(), _sampleOrder.end(), _rng);
+        for(auto idx : _sampleOrder)
+        {
+            buildPatches(&_sharedData[(size_t)idx * _sampleWordNum]);
+            for (int j = 0; j < _outputSize; j++)
+            {
+                backward(j, (_labels[idx] == j)? 1:0, forward(j, true));
+            }
+        }
+    }
+}
+
+/// @brief Load data and predict response using trained tsetlin machine.
+/// @param data 2D vector shaped in ( sampleNum * _inputSize )
+/// @return 2D vector shaped in ( sampleNum * _outputSize )
+vector<vector<int>>
+ConvolutionalTsetlinMachine::loadAndPredict(vector<vector<int>> &data)
+{
+    if( !dataIntegrityCheck(data)) throw;
+    vector<vector<int>> result(data.size(), vector<int>(_outputSize,0));
+    vector<uint64_t>    packed(_sampleWordNum, 0);
+    vector<int>         classSums(_outputSize, 0);
+    for (int sampleIdx = 0; sampleIdx < data.size(); sampleIdx++)
+    {
+        packBits(data[sampleIdx], packed.data());
+        buildPatches(packed.data());
+        for (int j = 0; j < _outputSize; j++)
+        {
+            classSums[j] = forward(j, false);
+        }
+        int competitorIdx = TsetlinMachine::argmax(classSums.data(), _outputSize);
+        result[sampleIdx][competitorIdx] = 1;
+    }
+    return result;
+}
+
+/// @brief Export current model.
+/// @return Literal states of every output's clauses and arguments.
+ConvolutionalTsetlinMachine::model
+ConvolutionalTsetlinMachine::exportModel()
+{
+    model result;
+    result.modelArgs = _myArgs;
+    result.tierTags = _tierTags;
+    result.clauses.resize(_outputSize);
+    for (int j = 0; j < _outputSize; j++)
+    {
+        for (int no = 0; no < 2 * _clausePerOutput; no++)
+        {
+            result.clauses[j].emplace_back(Clause(_arenas[j], no).exportModel());
+        }
+    }
+    return result;
+}
@@ -0,0 +1,114 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include "TsetlinMachine.h"
+using std::vector;
+using std::string;
+
+/// @brief Convolutional Tsetlin machine over positional sequences.
+///        Every clause is evaluated on each window of windowSize symbols and
+///        fires when any window satisfies it, so one clause covers a motif at all positions.
+///        Windows are cut from bit-packed samples with 64-bit funnel shifts instead of
+///        512-bit lane shifts, a window spans only a few words so wider shifts gain nothing.
+class ConvolutionalTsetlinMachine{
+public:
+    struct MachineArgs
+    {
+        int             sequenceLength;             // Symbols per sample, e.g. nucleotides of a 21-mer.
+        int             symbolWidth;                // Literals encoding one symbol, e.g. 4 for one-hot nucleotide.
+        int             extraSize = 0;              // Trailing non-positional literals appended to every window.
+        int             windowSize;
+        bool            positionLiterals = false;   // Thermometer-coded window position as extra literals.
+        int             outputSize;
+        int             clausePerOutput;
+        int             T;
+        double          sLow, sHigh;
+        double          dropoutRatio;
+        bool            shuffle = true;             // Visit samples in a fresh random order every epoch.
+        uint64_t        seed = 0;                   // Seed of shuffling and feedback stream, 0 means seeded from random device.
+        bool            hugePage = false;           // Back clause arenas with transparent huge pages.
+    };
+    struct model
+    {
+        MachineArgs                 modelArgs;
+        vector<string>              tierTags;
+        vector<vector<vector<int>>> clauses;    // Arranged in outputSize * (2 * clausePerOutput) * (literalNum * 2)
+        model(){}
+    };
+
+private:
+    const int                   _inputSize;         // sequenceLength * symbolWidth + extraSize
+    const int                   _outputSize;
+    const int                   _clausePerOutput;
+    const int                   _T;
+    const double                _dropoutRatio;
+    const int                   _windowBits;        // Literals covered by one window.
+    const int                   _positionBits;
+    const int                   _patchNum;          // Windows per sample.
+    const int                   _patchSize;         // Literals of one window including position and extra literals.
+    const int                   _sampleWordNum;     // 64-bit words per packed sample, one padding word included.
+    const int                   _patchWordNum;
+    const MachineArgs           _myArgs;
+    const vector<string>        _tierTags;
+
+    vector<ClauseArena>         _arenas;            // One per output, positive clauses followed by negative ones.
+    int                         _blockNum;
+
+    vector<uint64_t>            _sharedData;        // Row-major ( sampleNum * _sampleWordNum ) bit-packed samples.
+    vector<int>                 _labels;
+    vector<int>                 _sampleOrder;
+    pcg64_fast                  _rng;
+
+    vector<uint64_t>            _positionTemplate;  // Position literals of every window, ( _patchNum * _patchWordNum ).
+    vector<uint64_t>            _patchWords;
+    vector<__mmask16>           _patchMask;         // Row-major ( _patchNum * _blockNum ).
+    vector<__mmask16>           _patchMaskInverse;
+    vector<int>                 _firedPatch;        // Patch chosen for feedback of each clause, -1 if not fired.
+    vector<int>                 _candidates;
+
+    bool    dataIntegrityCheck(const vector<vector<int>> &data);
+    int     labelOf(const vector<int> &oneHot);
+    void    packBits(const vector<int> &original, uint64_t *target)noexcept;
+    void    buildPatches(const uint64_t *sample)noexcept;
+    int     vote(int output, int no, bool isTraining)noexcept;
+    int     forward(int output, bool isTraining)noexcept;
+    void    backward(int output, int response, int classSum)noexcept;
+
+    static uint64_t readBits(const uint64_t *src, size_t offset)noexcept;
+    static void     copyBits(const uint64_t *src, size_t srcOffset, int length,
+                             uint64_t *dst, size_t dstOffset)noexcept;
+
+public:
+    ConvolutionalTsetlinMachine(MachineArgs args, vector<string> tierTags)noexcept;
+
+    void                load(   vector<vector<int>> &data,
+                                vector<vector<int>> &response);
+    void                train(int epoch);
+
+    vector<vector<int>> loadAndPredict(vector<vector<int>> &data);
+
+    int                 inputSize()const noexcept   {return _inputSize;}
+    int                 patchSize()const noexcept   {return _patchSize;}
+    model               exportModel();
+};
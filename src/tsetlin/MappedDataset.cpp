@@ -0,0 +1,198 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "MappedDataset.h"
+#include "TsetlinMachine.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+    constexpr size_t    sectionAlign = 64;
+    size_t  alignUp(size_t offset)noexcept {return (offset + sectionAlign - 1) / sectionAlign * sectionAlign;}
+}
+
+/// @brief Map a file written by MappedDataset::write and validate its header.
+/// @param path Path of packed dataset file.
+MappedDataset::MappedDataset(const string &path):
+_fd(-1),
+_length(0),
+_base(nullptr)
+{
+    struct stat fileStat;
+    _fd = open(path.c_str(), O_RDONLY);
+    if(_fd < 0 || fstat(_fd, &fileStat) != 0 || fileStat.st_size < sizeof(Header))
+    {
+        std::cout<<"Cannot open packed dataset "<<path<<"."<<std::endl;
+        release();
+        throw;
+    }
+    _length = fileStat.st_size;
+    void *mapped = mmap(nullptr, _length, PROT_READ, MAP_SHARED, _fd, 0);
+    if(mapped == MAP_FAILED)
+    {
+        std::cout<<"Cannot map packed dataset "<<path<<"."<<std::endl;
+        release();
+        throw;
+    }
+    _base = (const char*)mapped;
+    std::memcpy(&_header, _base, sizeof(Header));
+
+    bool isRightFormat =    (std::memcmp(_header.magic, Header().magic, 4) == 0) &&
+                            (_header.version == Header().version) &&
+                            (_header.wordsPerSample == (_header.inputSize + 63) / 64) &&
+                            (_header.outputSize > 0 && _header.outputSize <= 256) &&
+                            (_header.labelOffset >= sizeof(Header)) &&
+                            (_header.labelOffset + _header.sampleNum <= _header.rowOffset) &&
+                            (_header.rowOffset % sectionAlign == 0) &&     // Rows are read as aligned words.
+                            (_header.rowOffset + _header.sampleNum * _header.wordsPerSample * sizeof(uint64_t) <= _length);
+    if(isRightFormat)
+    {
+        std::span<const uint8_t> stored = labels(0, _header.sampleNum);
+        isRightFormat = std::all_of(stored.begin(), stored.end(), [&](uint8_t label){return label < _header.outputSize;});
+    }
+    if(!isRightFormat)
+    {
+        std::cout<<"Packed dataset "<<path<<" failed integrity check."<<std::endl;
+        release();
+        throw;
+    }
+    advise(0, _length, MADV_SEQUENTIAL);
+}
+
+MappedDataset::~MappedDataset()noexcept
+{
+    release();
+}
+
+/// @brief Unmap the file and close its descriptor, also on failed construction.
+void
+MappedDataset::release()noexcept
+{
+    if(_base != nullptr) munmap((void*)_base, _length);
+    if(_fd >= 0) close(_fd);
+    _base = nullptr;
+    _fd = -1;
+}
+
+/// @brief Give paging advice on a byte range, widened to whole pages.
+void
+MappedDataset::advise(size_t offset, size_t length, int advice)const noexcept
+{
+    static const size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t first = offset / pageSize * pageSize;
+    size_t last = std::min(offset + length, _length);
+    if(last > first) madvise((void*)(_base + first), last - first, advice);
+}
+
+/// @return Bit-packed rows of samples in [first, first + count).
+std::span<const uint64_t>
+MappedDataset::rows(size_t first, size_t count)const noexcept
+{
+    const uint64_t *begin = (const uint64_t*)(_base + _header.rowOffset);
+    return std::span<const uint64_t>(begin + first * _header.wordsPerSample, count * _header.wordsPerSample);
+}
+
+/// @return Labels of samples in [first, first + count).
+std::span<const uint8_t>
+MappedDataset::labels(size_t first, size_t count)const noexcept
+{
+    const uint8_t *begin = (const uint8_t*)(_base + _header.labelOffset);
+    return std::span<const uint8_t>(begin + first, count);
+}
+
+/// @brief Ask kernel to start reading samples in [first, first + count) ahead of use.
+void
+MappedDataset::willNeed(size_t first, size_t count)const noexcept
+{
+    const size_t rowBytes = _header.wordsPerSample * sizeof(uint64_t);
+    advise(_header.labelOffset + first, count, MADV_WILLNEED);
+    advise(_header.rowOffset + first * rowBytes, count * rowBytes, MADV_WILLNEED);
+}
+
+/// @brief Drop pages of consumed samples in [first, first + count), file is untouched.
+void
+MappedDataset::release(size_t first, size_t count)const noexcept
+{
+    const size_t rowBytes = _header.wordsPerSample * sizeof(uint64_t);
+    advise(_header.labelOffset + first, count, MADV_DONTNEED);
+    advise(_header.rowOffset + first * rowBytes, count * rowBytes, MADV_DONTNEED);
+}
+
+/// @brief Bit-pack samples and write them with their labels.
+/// @param path Output file path.
+/// @param data 2D vector shaped in ( sampleNum * inputSize )
+/// @param response One-hot 2D vector shaped in ( sampleNum * outputSize )
+void
+MappedDataset::write(   const string &path,
+                        const vector<vector<int>> &data,
+                        const vector<vector<int>> &response)
+{
+    Header header;
+    header.sampleNum = data.size();
+    header.inputSize = data.empty()? 0 : data[0].size();
+    header.outputSize = response.empty()? 0 : response[0].size();
+    header.wordsPerSample = (header.inputSize + 63) / 64;
+    header.labelOffset = alignUp(sizeof(Header));
+    header.rowOffset = alignUp(header.labelOffset + header.sampleNum);
+
+    bool isRightLength = (header.inputSize > 0) && (response.size() == data.size()) &&
+                         (header.outputSize <= 256);     // Labels are stored as one byte.
+    for (size_t i = 0; i < data.size() && isRightLength; i++)
+    {
+        isRightLength = (data[i].size() == header.inputSize) && (response[i].size() == header.outputSize) &&
+                        (TsetlinMachine::hotIndex(response[i]) >= 0);
+    }
+    std::ofstream output(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!isRightLength || !output)
+    {
+        std::cout<<"Cannot write packed dataset "<<path<<"."<<std::endl;
+        throw;
+    }
+
+    vector<char> padding(sectionAlign, 0);
+    output.write((const char*)&header, sizeof(Header));
+    output.write(padding.data(), header.labelOffset - sizeof(Header));
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        uint8_t label = TsetlinMachine::hotIndex(response[i]);
+        output.put(label);
+    }
+    output.write(padding.data(), header.rowOffset - header.labelOffset - header.sampleNum);
+    vector<uint64_t> words(header.wordsPerSample);
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        std::fill(words.begin(), words.end(), 0);
+        for (int k = 0; k < header.inputSize; k++)
+        {
+            words[k / 64] |= (uint64_t)(data[i][k] > 0) << (k % 64);   // Same predicate as maskInput.
+        }
+        output.write((const char*)words.data(), words.size() * sizeof(uint64_t));
+    }
+}
@@ -0,0 +1,80 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+using std::vector;
+using std::string;
+
+/// @brief Read-only memory-mapped file of bit-packed samples and their labels, for datasets
+///        that do not fit in memory. Pages are read ahead sequentially by the kernel and
+///        dropped after use, so only a window of the file is resident at any time.
+///        Layout: Header | labels (one byte per sample) | rows (wordsPerSample words per sample),
+///        sections start at 64-byte aligned offsets.
+class MappedDataset{
+public:
+    struct Header
+    {
+        char        magic[4] = {'T','M','P','K'};
+        uint32_t    version = 1;
+        uint32_t    inputSize = 0;
+        uint32_t    outputSize = 0;
+        uint32_t    wordsPerSample = 0;
+        uint32_t    reserved = 0;
+        uint64_t    sampleNum = 0;
+        uint64_t    labelOffset = 0;
+        uint64_t    rowOffset = 0;
+    };
+
+private:
+    int                 _fd;
+    size_t              _length;
+    const char          *_base;
+    Header              _header;
+
+    void    advise(size_t offset, size_t length, int advice)const noexcept;
+    void    release()noexcept;
+
+public:
+    MappedDataset(const string &path);
+    ~MappedDataset()noexcept;
+    MappedDataset(const MappedDataset&) = delete;
+    MappedDataset& operator=(const MappedDataset&) = delete;
+
+    size_t      size()const noexcept            {return _header.sampleNum;}
+    int         inputSize()const noexcept       {return _header.inputSize;}
+    int         outputSize()const noexcept      {return _header.outputSize;}
+    int         wordsPerSample()const noexcept  {return _header.wordsPerSample;}
+
+    std::span<const uint64_t>   rows(size_t first, size_t count)const noexcept;
+    std::span<const uint8_t>    labels(size_t first, size_t count)const noexcept;
+    void                        willNeed(size_t first, size_t count)const noexcept;
+    void                        release(size_t first, size_t count)const noexcept;
+
+    static void write(  const string &path,
+                        const vector<vector<int>> &data,
+                        const vector<vector<int>> &response);
+};
@@ -0,0 +1,386 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "ModelFile.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+    constexpr size_t    sectionAlign = 64;
+    size_t  alignUp(size_t offset)noexcept {return (offset + sectionAlign - 1) / sectionAlign * sectionAlign;}
+}
+
+ModelFile::ModelFile()noexcept:
+_fd(-1),
+_length(0),
+_base(nullptr)
+{
+}
+
+ModelFile::~ModelFile()noexcept
+{
+    if(_base != nullptr) munmap(_base, _length);
+    if(_fd >= 0) close(_fd);
+}
+
+/// @brief FNV-1a over 64bit words, length is a multiple of 8 in model files.
+uint64_t
+ModelFile::checksum(const char *data, size_t length)noexcept
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i + 8 <= length; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/// @brief Map a model file privately, clause arenas are used in place.
+/// @param path Path of model file written by ModelFile::write.
+/// @param verify Check checksum of whole file, which touches every page.
+/// @return Mapped model file shared by machines built from it.
+std::shared_ptr<ModelFile>
+ModelFile::open(const string &path, bool verify)
+{
+    std::shared_ptr<ModelFile> file(new ModelFile());
+    struct stat fileStat;
+    file->_fd = ::open(path.c_str(), O_RDONLY);
+    if(file->_fd < 0 || fstat(file->_fd, &fileStat) != 0 || fileStat.st_size < sizeof(Header))
+    {
+        std::cout<<"Cannot open model file "<<path<<"."<<std::endl;
+        throw;
+    }
+    file->_length = fileStat.st_size;
+    void *mapped = mmap(nullptr, file->_length, PROT_READ | PROT_WRITE, MAP_PRIVATE, file->_fd, 0);
+    if(mapped == MAP_FAILED)
+    {
+        std::cout<<"Cannot map model file "<<path<<"."<<std::endl;
+        throw;
+    }
+    file->_base = (char*)mapped;
+    std::memcpy(&file->_header, file->_base, sizeof(Header));
+
+    const Header &header = file->_header;
+    size_t arenaBytes = ClauseArena::bytesFor(ClauseArena::ArenaArgs{2 * header.clausePerOutput, header.inputSize, false});
+    bool isRightFormat =    (std::memcmp(header.magic, Header().magic, 4) == 0) &&
+                            (header.version == Header().version) &&
+                            (header.fileBytes == file->_length) &&
+                            (header.outputSize > 0) &&
+                            (header.arenaBytes == arenaBytes) &&
+                            (header.arenaOffset % sectionAlign == 0) &&
+                            (header.arenaOffset + header.outputSize * header.arenaBytes <= header.remapOffset) &&
+                            (header.remapOffset + header.remapNum * sizeof(int32_t) <= header.tagOffset) &&
+                            (header.tagOffset <= header.fileBytes);
+    for (uint32_t k = 0; k < header.remapNum && isRightFormat; k++)
+    {
+        int32_t column;
+        std::memcpy(&column, file->_base + header.remapOffset + k * sizeof(int32_t), sizeof(int32_t));
+        isRightFormat = (column >= 0) && (column < header.originalInputSize);
+    }
+    if(!isRightFormat)
+    {
+        std::cout<<"Model file "<<path<<" failed integrity check."<<std::endl;
+        throw;
+    }
+    if(verify && checksum(file->_base + sizeof(Header), file->_length - sizeof(Header)) != header.checksum)
+    {
+        std::cout<<"Model file "<<path<<" failed checksum."<<std::endl;
+        throw;
+    }
+    return file;
+}
+
+/// @brief Write args and clause arenas of a machine.
+/// @param path Output file path.
+/// @param machine Machine to be saved.
+void
+ModelFile::write(const string &path, const TsetlinMachine &machine)
+{
+    vector<const ClauseArena*> arenas;
+    for (int j = 0; j < machine.outputSize(); j++) arenas.push_back(&machine.state(j));
+    write(path, machine.args(), machine.tierTags(), arenas, 0);
+}
+
+/// @brief Write a snapshot taken from a machine, e.g. by a background checkpoint writer.
+/// @param path Output file path.
+/// @param snapshot Flat copy of machine state.
+/// @return Checksum of the file, which names it as base of delta files.
+uint64_t
+ModelFile::write(const string &path, const TsetlinMachine::Snapshot &snapshot)
+{
+    vector<const ClauseArena*> arenas;
+    for(auto &arena : snapshot.arenas) arenas.push_back(&arena);
+    return write(path, snapshot.modelArgs, snapshot.tierTags, arenas, snapshot.epoch);
+}
+
+/// @param path Output file path.
+/// @param args Machine args.
+/// @param tags Tier tags.
+/// @param arenas Clause arena of each automata.
+/// @param epoch Epochs trained.
+/// @return Checksum recorded in header.
+uint64_t
+ModelFile::write(   const string &path,
+                    const TsetlinMachine::MachineArgs &args,
+                    const vector<string> &tags,
+                    const vector<const ClauseArena*> &arenas,
+                    uint64_t epoch)
+{
+    if(arenas.empty() || (int)arenas.size() != args.outputSize)
+    {
+        std::cout<<"Cannot write model file "<<path<<", expect one clause arena per output."<<std::endl;
+        throw;
+    }
+    Header header;
+    header.inputSize = args.inputSize;
+    header.outputSize = args.outputSize;
+    header.clausePerOutput = args.clausePerOutput;
+    header.T = args.T;
+    header.sLow = args.sLow;
+    header.sHigh = args.sHigh;
+    header.dropoutRatio = args.dropoutRatio;
+    header.seed = args.seed;
+    header.shuffle = args.shuffle;
+    header.hugePage = args.hugePage;
+    header.originalInputSize = args.originalInputSize;
+    header.remapNum = args.inputRemap.size();
+    header.tagNum = tags.size();
+    header.arenaBytes = arenas[0]->bytes();
+    header.epoch = epoch;
+    header.arenaOffset = alignUp(sizeof(Header));
+    header.remapOffset = alignUp(header.arenaOffset + header.outputSize * header.arenaBytes);
+    header.tagOffset = alignUp(header.remapOffset + header.remapNum * sizeof(int32_t));
+
+    ////////// Assemble payload in memory, then checksum and write it once //////////
+    size_t tagBytes = 0;
+    for(auto &tag : tags) tagBytes += sizeof(uint32_t) + tag.size();
+    header.fileBytes = alignUp(header.tagOffset + tagBytes);
+    vector<char> payload(header.fileBytes - sizeof(Header), 0);
+    auto at = [&](uint64_t offset){return payload.data() + (offset - sizeof(Header));};
+    for (int j = 0; j < header.outputSize; j++)
+    {
+        std::memcpy(at(header.arenaOffset + j * header.arenaBytes), arenas[j]->data(), header.arenaBytes);
+    }
+    for (uint32_t k = 0; k < header.remapNum; k++)
+    {
+        int32_t column = args.inputRemap[k];
+        std::memcpy(at(header.remapOffset + k * sizeof(int32_t)), &column, sizeof(int32_t));
+    }
+    char *cursor = at(header.tagOffset);
+    for(auto &tag : tags)
+    {
+        uint32_t length = tag.size();
+        std::memcpy(cursor, &length, sizeof(uint32_t));
+        std::memcpy(cursor + sizeof(uint32_t), tag.data(), length);
+        cursor += sizeof(uint32_t) + length;
+    }
+    header.checksum = checksum(payload.data(), payload.size());
+
+    std::ofstream output(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    output.write((const char*)&header, sizeof(Header));
+    output.write(payload.data(), payload.size());
+    if(!output)
+    {
+        std::cout<<"Cannot write model file "<<path<<"."<<std::endl;
+        throw;
+    }
+    return header.checksum;
+}
+
+/// @return Machine args stored in header.
+TsetlinMachine::MachineArgs
+ModelFile::args()const
+{
+    TsetlinMachine::MachineArgs args;
+    args.inputSize = _header.inputSize;
+    args.outputSize = _header.outputSize;
+    args.clausePerOutput = _header.clausePerOutput;
+    args.T = _header.T;
+    args.sLow = _header.sLow;
+    args.sHigh = _header.sHigh;
+    args.dropoutRatio = _header.dropoutRatio;
+    args.seed = _header.seed;
+    args.shuffle = _header.shuffle;
+    args.hugePage = _header.hugePage;
+    args.originalInputSize = _header.originalInputSize;
+    args.inputRemap.resize(_header.remapNum);
+    for (uint32_t k = 0; k < _header.remapNum; k++)
+    {
+        int32_t column;
+        std::memcpy(&column, _base + _header.remapOffset + k * sizeof(int32_t), sizeof(int32_t));
+        args.inputRemap[k] = column;
+    }
+    args.tierTags = tierTags();
+    return args;
+}
+
+/// @return Tier tags stored after the arenas.
+vector<string>
+ModelFile::tierTags()const
+{
+    vector<string>  tags;
+    const char      *cursor = _base + _header.tagOffset;
+    const char      *end = _base + _length;
+    for (uint32_t k = 0; k < _header.tagNum && cursor + sizeof(uint32_t) <= end; k++)
+    {
+        uint32_t length;
+        std::memcpy(&length, cursor, sizeof(uint32_t));
+        if(cursor + sizeof(uint32_t) + length > end) break;
+        tags.emplace_back(cursor + sizeof(uint32_t), length);
+        cursor += sizeof(uint32_t) + length;
+    }
+    return tags;
+}
+
+/// @brief Write literal blocks marked dirty in a snapshot, plus arena tails in full.
+/// @param path Output file path.
+/// @param snapshot Snapshot whose dirty bits cover all changes since the previous checkpoint.
+/// @param baseChecksum Checksum of the base model file.
+/// @param sequence Position of this delta in the chain of its base.
+/// @return Bytes written.
+size_t
+ModelFile::writeDelta(  const string &path,
+                        const TsetlinMachine::Snapshot &snapshot,
+                        uint64_t baseChecksum,
+                        uint32_t sequence)
+{
+    if(snapshot.arenas.empty())
+    {
+        std::cout<<"Cannot write delta file "<<path<<", snapshot holds no clause arena."<<std::endl;
+        throw;
+    }
+    const int           outputSize = snapshot.arenas.size();
+    const ClauseArena   &shape = snapshot.arenas[0];
+    vector<DeltaEntry>  entries;
+    for (int j = 0; j < outputSize; j++)
+    {
+        const ClauseArena &arena = snapshot.arenas[j];
+        for (int no = 0; no < arena.clauseNum(); no++)
+        {
+            for (int b = 0; b < arena.blockNum(); b++)
+            {
+                if(arena.isDirty(no, b)) entries.push_back(DeltaEntry{(uint32_t)j, (uint32_t)no, (uint32_t)b, 0});
+            }
+        }
+    }
+    DeltaHeader header;
+    header.baseChecksum = baseChecksum;
+    header.sequence = sequence;
+    header.outputSize = outputSize;
+    header.arenaBytes = shape.bytes();
+    header.tailOffset = shape.tailOffset();
+    header.entryNum = entries.size();
+    header.epoch = snapshot.epoch;
+    const size_t tailBytes = header.arenaBytes - header.tailOffset;
+    header.tailsOffset = alignUp(sizeof(DeltaHeader));
+    header.entryOffset = alignUp(header.tailsOffset + outputSize * tailBytes);
+    header.blockOffset = alignUp(header.entryOffset + entries.size() * sizeof(DeltaEntry));
+    header.fileBytes = alignUp(header.blockOffset + entries.size() * 2 * sizeof(__m512i));
+
+    vector<char> payload(header.fileBytes - sizeof(DeltaHeader), 0);
+    auto at = [&](uint64_t offset){return payload.data() + (offset - sizeof(DeltaHeader));};
+    for (int j = 0; j < outputSize; j++)
+    {
+        std::memcpy(at(header.tailsOffset + j * tailBytes), snapshot.arenas[j].data() + header.tailOffset, tailBytes);
+    }
+    if(!entries.empty()) std::memcpy(at(header.entryOffset), entries.data(), entries.size() * sizeof(DeltaEntry));
+    for (size_t k = 0; k < entries.size(); k++)
+    {
+        const ClauseArena &arena = snapshot.arenas[entries[k].output];
+        char *blocks = at(header.blockOffset + k * 2 * sizeof(__m512i));
+        std::memcpy(blocks, arena.positiveLiterals(entries[k].no) + entries[k].block, sizeof(__m512i));
+        std::memcpy(blocks + sizeof(__m512i), arena.negativeLiterals(entries[k].no) + entries[k].block, sizeof(__m512i));
+    }
+    header.checksum = checksum(payload.data(), payload.size());
+
+    std::ofstream output(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    output.write((const char*)&header, sizeof(DeltaHeader));
+    output.write(payload.data(), payload.size());
+    if(!output)
+    {
+        std::cout<<"Cannot write delta file "<<path<<"."<<std::endl;
+        throw;
+    }
+    return header.fileBytes;
+}
+
+/// @brief Apply a delta file to a machine holding state of its base and all earlier deltas.
+/// @param path Delta file path.
+/// @param baseChecksum Checksum of the base the machine was built from.
+/// @param sequence Expected position of this delta in the chain.
+/// @param machine Machine updated in place.
+/// @return Epoch recorded in the delta, -1 when it is missing, of another base or damaged.
+long
+ModelFile::applyDelta(  const string &path,
+                        uint64_t baseChecksum,
+                        uint32_t sequence,
+                        TsetlinMachine &machine)
+{
+    std::ifstream input(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if(!input) return -1;
+    vector<char> content(input.tellg());
+    input.seekg(0);
+    input.read(content.data(), content.size());
+    if(!input || content.size() < sizeof(DeltaHeader)) return -1;
+
+    DeltaHeader header;
+    std::memcpy(&header, content.data(), sizeof(DeltaHeader));
+    const ClauseArena   &shape = machine.state(0);
+    const size_t        tailBytes = header.arenaBytes - header.tailOffset;
+    bool isRightFormat =    (std::memcmp(header.magic, DeltaHeader().magic, 4) == 0) &&
+                            (header.version == DeltaHeader().version) &&
+                            (header.fileBytes == content.size()) &&
+                            (header.baseChecksum == baseChecksum) &&
+                            (header.sequence == sequence) &&
+                            (header.outputSize == machine.outputSize()) &&
+                            (header.arenaBytes == shape.bytes()) &&
+                            (header.tailOffset == shape.tailOffset()) &&
+                            (header.blockOffset + header.entryNum * 2 * sizeof(__m512i) <= header.fileBytes) &&
+                            (checksum(content.data() + sizeof(DeltaHeader), content.size() - sizeof(DeltaHeader)) == header.checksum);
+    if(!isRightFormat) return -1;
+
+    for (int j = 0; j < header.outputSize; j++)
+    {
+        std::memcpy(machine.state(j).data() + header.tailOffset, content.data() + header.tailsOffset + j * tailBytes, tailBytes);
+    }
+    for (size_t k = 0; k < header.entryNum; k++)
+    {
+        DeltaEntry entry;
+        std::memcpy(&entry, content.data() + header.entryOffset + k * sizeof(DeltaEntry), sizeof(DeltaEntry));
+        if(entry.output >= header.outputSize) continue;
+        ClauseArena &arena = machine.state(entry.output);
+        if(entry.no >= arena.clauseNum() || entry.block >= arena.blockNum()) continue;
+        const char *blocks = content.data() + header.blockOffset + k * 2 * sizeof(__m512i);
+        std::memcpy(arena.positiveLiterals(entry.no) + entry.block, blocks, sizeof(__m512i));
+        std::memcpy(arena.negativeLiterals(entry.no) + entry.block, blocks + sizeof(__m512i), sizeof(__m512i));
+    }
+    return header.epoch;
+}
@@ -0,0 +1,127 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "TsetlinMachine.h"
+using std::vector;
+using std::string;
+
+/// @brief Versioned binary model file. The header carries machine args and a checksum,
+///        clause arenas follow at 64-byte aligned offsets byte for byte as they are laid out
+///        in memory, so a mapped file is served without unpacking or copying any state.
+///        Layout: Header | arenas (outputSize * arenaBytes) | input remap | tier tags.
+///        Machines built from one ModelFile share its private pages, train at most one of them.
+///        A delta file holds only literal blocks changed since the previous checkpoint and
+///        the small per clause state after them, it applies on top of the base it names.
+class ModelFile{
+public:
+    struct Header
+    {
+        char        magic[4] = {'T','M','M','D'};
+        uint32_t    version = 2;
+        uint64_t    checksum = 0;           // Of every byte after the header.
+        uint64_t    fileBytes = 0;
+        int32_t     inputSize = 0;
+        int32_t     outputSize = 0;
+        int32_t     clausePerOutput = 0;
+        int32_t     T = 0;
+        double      sLow = 0, sHigh = 0;
+        double      dropoutRatio = 0;
+        uint64_t    seed = 0;
+        uint8_t     shuffle = 1;
+        uint8_t     hugePage = 0;
+        uint16_t    reserved = 0;
+        int32_t     originalInputSize = 0;
+        uint32_t    remapNum = 0;
+        uint32_t    tagNum = 0;
+        uint64_t    arenaBytes = 0;         // Bytes of one automata's arena.
+        uint64_t    arenaOffset = 0;
+        uint64_t    remapOffset = 0;
+        uint64_t    tagOffset = 0;
+        uint64_t    epoch = 0;              // Epochs trained, set by checkpoints.
+    };
+    struct DeltaHeader
+    {
+        char        magic[4] = {'T','M','D','L'};
+        uint32_t    version = 1;
+        uint64_t    checksum = 0;           // Of every byte after the header.
+        uint64_t    fileBytes = 0;
+        uint64_t    baseChecksum = 0;       // Checksum of the model file this delta applies to.
+        uint32_t    sequence = 0;           // Deltas of one base apply in order 1, 2, ...
+        int32_t     outputSize = 0;
+        uint64_t    arenaBytes = 0;
+        uint64_t    tailOffset = 0;         // Arena bytes from here on are stored in full.
+        uint64_t    entryNum = 0;           // Changed literal block pairs.
+        uint64_t    tailsOffset = 0;
+        uint64_t    entryOffset = 0;
+        uint64_t    blockOffset = 0;
+        uint64_t    epoch = 0;
+    };
+    struct DeltaEntry
+    {
+        uint32_t    output;
+        uint32_t    no;
+        uint32_t    block;
+        uint32_t    reserved;
+    };
+
+private:
+    int                 _fd;
+    size_t              _length;
+    char                *_base;
+    Header              _header;
+
+    ModelFile()noexcept;
+    static uint64_t     checksum(const char *data, size_t length)noexcept;
+    static uint64_t     write(  const string &path,
+                                const TsetlinMachine::MachineArgs &args,
+                                const vector<string> &tags,
+                                const vector<const ClauseArena*> &arenas,
+                                uint64_t epoch);
+
+public:
+    ModelFile(const ModelFile&) = delete;
+    ModelFile& operator=(const ModelFile&) = delete;
+    ~ModelFile()noexcept;
+
+    static std::shared_ptr<ModelFile>   open(const string &path, bool verify = true);
+    static void                         write(const string &path, const TsetlinMachine &machine);
+    static uint64_t                     write(const string &path, const TsetlinMachine::Snapshot &snapshot);
+    static size_t                       writeDelta( const string &path,
+                                                    const TsetlinMachine::Snapshot &snapshot,
+                                                    uint64_t baseChecksum,
+                                                    uint32_t sequence);
+    static long                         applyDelta( const string &path,
+                                                    uint64_t baseChecksum,
+                                                    uint32_t sequence,
+                                                    TsetlinMachine &machine);
+
+    TsetlinMachine::MachineArgs args()const;
+    vector<string>              tierTags()const;
+    char*                       arena(int output)const noexcept {return _base + _header.arenaOffset + output * _header.arenaBytes;}
+    const Header&               header()const noexcept          {return _header;}
+};
@@ -0,0 +1,180 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "MultiTsetlinTrainer.h"
+#include <thread>
+#include <atomic>
+#include <numeric>
+#include <algorithm>
+
+MultiTsetlinTrainer::MultiTsetlinTrainer(TrainerArgs args, vector<string> tierTags):
+_configNum(args.configs.size()),
+_threadNum(std::max(1, std::min(args.threadNum, (int)args.configs.size()))),
+_inputSize(args.configs.empty()? 0:args.configs[0].inputSize),
+_outputSize(args.configs.empty()? 0:args.configs[0].outputSize),
+_blockNum(_inputSize/16 + (_inputSize%16==0? 0:1)),
+_numaAware(args.numaAware),
+_shuffle(args.configs.empty()? true:args.configs[0].shuffle)
+{
+    if(args.configs.empty())
+    {
+        std::cout<<"Trainer needs at least one configuration."<<std::endl;
+        throw;
+    }
+    for(auto &config : args.configs)
+    {
+        bool isSameInput =  (config.inputSize == _inputSize) &&
+                            (config.inputRemap == args.configs[0].inputRemap) &&        // Masks are shared, so columns must mean the same.
+                            (config.originalInputSize == args.configs[0].originalInputSize);
+        if(!isSameInput || config.outputSize != _outputSize || config.shuffle != _shuffle)
+        {
+            std::cout<<"Configurations failed integrity check, shapes, input remaps or shuffle flags differ."<<std::endl;
+            throw;
+        }
+    }
+    if(args.seed != 0)
+    {
+        std::seed_seq sequence{(uint32_t)args.seed, (uint32_t)(args.seed >> 32)};  // A raw seed loses its low bits in pcg64_fast.
+        _rng.seed(sequence);
+    }
+    else
+    {
+        pcg_extras::seed_seq_from<std::random_device> seed_source;
+        _rng.seed(seed_source);
+    }
+    for(auto &config : args.configs)
+    {
+        _machines.emplace_back(std::make_unique<TsetlinMachine>(config, tierTags));
+    }
+}
+
+/// @brief Run job(0..jobNum-1) on a pool of _threadNum workers.
+/// @param jobNum Number of jobs.
+/// @param job Callable taking job index and worker index.
+template<typename Job>
+void
+MultiTsetlinTrainer::parallelFor(int jobNum, Job job)
+{
+    std::atomic<int>    next(0);
+    vector<std::thread> threadPool;
+    for (int t = 0; t < _threadNum; t++)
+    {
+        threadPool.emplace_back([&, t]()
+        {
+            if(_numaAware)
+            {
+                NumaTopology &topology = NumaTopology::instance();
+                topology.pinThread(topology.nodeOf(t, _threadNum));
+            }
+            for (int i = next++; i < jobNum; i = next++) job(i, t);
+        });
+    }
+    for (int t = 0; t < _threadNum; t++)
+    {
+        threadPool[t].join();
+    }
+}
+
+/// @brief Pack data and compute input masks once for all configurations.
+/// @param data 2D vector shaped in ( sampleNum * inputSize )
+/// @param response 2D vector shaped in ( sampleNum * outputSize )
+void
+MultiTsetlinTrainer::load(  vector<vector<int>> &data,
+                            vector<vector<int>> &response)
+{
+    TsetlinMachine::PackedSet packed = _machines[0]->packSet(data, response);
+    const size_t sampleNum = packed.data.size();
+    _masks.assign(sampleNum * _blockNum, 0);
+    _masksInverse.assign(sampleNum * _blockNum, 0);
+    for (size_t i = 0; i < sampleNum; i++)
+    {
+        _machines[0]->maskInput(packed.data[i],
+                                &_masks[i * _blockNum],
+                                &_masksInverse[i * _blockNum]);
+    }
+    _labels = std::move(packed.labels);
+    _maskReplicas.clear();
+    _inverseReplicas.clear();
+    if(_numaAware && NumaTopology::instance().nodeNum() > 1)
+    {
+        _maskReplicas = NumaTopology::instance().replicate(_masks);
+        _inverseReplicas = NumaTopology::instance().replicate(_masksInverse);
+    }
+    _sampleOrder.resize(sampleNum);
+    std::iota(_sampleOrder.begin(), _sampleOrder.end(), 0);
+}
+
+/// @brief Train all configurations, each worker streams every sample through its group.
+/// @param epoch Max count of repeat training time.
+void
+MultiTsetlinTrainer::train(int epoch)
+{
+    for (int i = 0; i < epoch; i++)
+    {
+        if(_shuffle) std::shuffle(_sampleOrder.begin(), _sampleOrder.end(), _rng);
+        parallelFor(_threadNum, [&](int group, int worker)
+        {
+            const int first = (long)_configNum * group / _threadNum;
+            const int last  = (long)_configNum * (group + 1) / _threadNum;
+            const int node  = NumaTopology::instance().nodeOf(worker, _threadNum);
+            const __mmask16 *masks = _maskReplicas.empty()? _masks.data() : _maskReplicas[node].data();
+            const __mmask16 *masksInverse = _inverseReplicas.empty()? _masksInverse.data() : _inverseReplicas[node].data();
+            for(auto idx : _sampleOrder)
+            {
+                const __mmask16 *in = &masks[(size_t)idx * _blockNum];
+                const __mmask16 *inInverse = &masksInverse[(size_t)idx * _blockNum];
+                for (int c = first; c < last; c++)
+                {
+                    _machines[c]->update(in, inInverse, _labels[idx]);
+                }
+            }
+        });
+    }
+}
+
+/// @brief Evaluate every configuration on the same packed set.
+/// @param validation Set packed by packSet of any machine with the same input size.
+/// @return Accuracy of each configuration, in the order of configs.
+vector<double>
+MultiTsetlinTrainer::evaluate(TsetlinMachine::PackedSet &validation)
+{
+    vector<double> accuracy(_configNum, 0);
+    parallelFor(_configNum, [&](int c, int worker)
+    {
+        accuracy[c] = _machines[c]->evaluate(validation);
+    });
+    return accuracy;
+}
+
+/// @brief Export models of all configurations.
+/// @return Models in the order of configs.
+vector<TsetlinMachine::model>
+MultiTsetlinTrainer::exportModels()
+{
+    vector<TsetlinMachine::model> models;
+    for(auto &machine : _machines)
+    {
+        models.emplace_back(machine->exportModel());
+    }
+    return models;
+}
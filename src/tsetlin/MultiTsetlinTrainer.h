@@ -0,0 +1,76 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include <memory>
+#include "TsetlinMachine.h"
+#include "NumaTopology.h"
+using std::vector;
+using std::string;
+
+/// @brief Trains K machine configurations of the same input size in lockstep,
+///        each sample is streamed once through all configurations before the next one.
+class MultiTsetlinTrainer{
+public:
+    struct TrainerArgs
+    {
+        vector<TsetlinMachine::MachineArgs> configs;    // Must share input shape and remap, outputSize and shuffle.
+        int             threadNum = 1;                  // Workers own disjoint groups of configurations.
+        uint64_t        seed = 0;                       // Seed of shared sample order, 0 means random device.
+        bool            numaAware = false;              // Pin workers to nodes and replicate masks per node.
+    };
+
+private:
+    const int                                   _configNum;
+    const int                                   _threadNum;
+    const int                                   _inputSize;
+    const int                                   _outputSize;
+    const int                                   _blockNum;
+    const bool                                  _numaAware;
+    const bool                                  _shuffle;       // Flag of configs, the stream is shared.
+    pcg64_fast                                  _rng;
+
+    vector<std::unique_ptr<TsetlinMachine>>     _machines;      // One machine per configuration.
+    vector<__mmask16>                           _masks;         // Row-major ( sampleNum * blockNum ).
+    vector<__mmask16>                           _masksInverse;
+    vector<vector<__mmask16>>                   _maskReplicas;      // Node-local copies, empty on one node.
+    vector<vector<__mmask16>>                   _inverseReplicas;
+    vector<int>                                 _labels;
+    vector<int>                                 _sampleOrder;   // Shared by all configurations.
+
+    template<typename Job>
+    void    parallelFor(int jobNum, Job job);
+
+public:
+    MultiTsetlinTrainer(TrainerArgs args, vector<string> tierTags);
+
+    void                load(   vector<vector<int>> &data,
+                                vector<vector<int>> &response);
+    void                train(int epoch);
+
+    vector<double>      evaluate(TsetlinMachine::PackedSet &validation);
+    TsetlinMachine&     machine(int configIdx)noexcept  {return *_machines[configIdx];}
+    int                 configNum()const noexcept       {return _configNum;}
+
+    vector<TsetlinMachine::model>   exportModels();
+};
@@ -0,0 +1,125 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "NumaTopology.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+
+NumaTopology::NumaTopology()noexcept:
+_nextSlot(0)
+{
+    std::ifstream   online("/sys/devices/system/node/online");
+    string          onlineList;
+    std::getline(online, onlineList);
+    try
+    {
+        for(int id : parseList(onlineList))     // Node IDs may have holes, e.g. "0,2-3".
+        {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+            string list;
+            std::getline(file, list);
+            vector<int> cpus = parseList(list);
+            if(cpus.empty()) continue;          // Memory-only nodes run no workers.
+            _nodeCpus.emplace_back(cpus);
+            _nodeIds.push_back(id);
+        }
+    }
+    catch(const std::exception &error)          // Malformed sysfs list, treat machine as one node.
+    {
+        std::cout<<"Cannot parse NUMA topology ("<<error.what()<<"), using a single node."<<std::endl;
+        _nodeCpus.clear();
+        _nodeIds.clear();
+    }
+    if(_nodeCpus.empty())
+    {
+        _nodeCpus.emplace_back();
+        _nodeIds.push_back(0);
+        for (int cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); cpu++)
+        {
+            _nodeCpus[0].push_back(cpu);
+        }
+    }
+}
+
+/// @brief Parse a range list of sysfs, e.g. "0-3,8-11" of cpulist or online.
+/// @param list Content of a list file.
+/// @return Listed numbers, throws std::invalid_argument or std::out_of_range on malformed list.
+vector<int>
+NumaTopology::parseList(const string &list)
+{
+    vector<int>         result;
+    std::stringstream   ss(list);
+    string              range;
+    while(std::getline(ss, range, ','))
+    {
+        if(range.empty()) continue;
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = (dash == string::npos)? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; cpu++) result.push_back(cpu);
+    }
+    return result;
+}
+
+/// @brief Topology of this machine, read once.
+NumaTopology&
+NumaTopology::instance()noexcept
+{
+    static NumaTopology topology;
+    return topology;
+}
+
+/// @brief Node of a worker when workers are spread over nodes in contiguous blocks.
+/// @param worker Index of worker.
+/// @param workerNum Number of workers.
+/// @return Node index.
+int
+NumaTopology::nodeOf(int worker, int workerNum)const noexcept
+{
+    return (long)worker * nodeNum() / std::max(1, workerNum);
+}
+
+/// @brief Restrict calling thread to CPUs of one node.
+/// @param node Node index.
+/// @return Whether the affinity is applied.
+bool
+NumaTopology::pinThread(int node)const noexcept
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(auto cpu : _nodeCpus[node]) CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+/// @brief Pin calling thread to a node, consecutive callers are spread over nodes in turn.
+/// @return Node the thread is pinned to.
+int
+NumaTopology::pinNextThread()noexcept
+{
+    int node = _nextSlot++ % nodeNum();
+    pinThread(node);
+    return node;
+}
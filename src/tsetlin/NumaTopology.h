@@ -0,0 +1,81 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+using std::vector;
+using std::string;
+
+/// @brief NUMA nodes and their CPUs read from sysfs, with helpers to pin threads
+///        and replicate data so that every node reads memory first-touched by itself.
+///        Machines without NUMA information are treated as one node holding all CPUs.
+///        Nodes are indexed densely over nodes having CPUs, nodeId gives the kernel ID.
+class NumaTopology{
+private:
+    vector<vector<int>>     _nodeCpus;
+    vector<int>             _nodeIds;       // Kernel node ID of each entry, IDs may be sparse.
+    std::atomic<int>        _nextSlot;      // Round-robin cursor of pinNextThread.
+
+    NumaTopology()noexcept;
+    static vector<int>  parseList(const string &list);
+
+public:
+    NumaTopology(const NumaTopology&) = delete;
+    NumaTopology& operator=(const NumaTopology&) = delete;
+
+    static NumaTopology&    instance()noexcept;
+
+    int                 nodeNum()const noexcept             {return _nodeCpus.size();}
+    const vector<int>&  cpus(int node)const noexcept        {return _nodeCpus[node];}
+    int                 nodeId(int node)const noexcept      {return _nodeIds[node];}
+    int                 nodeOf(int worker, int workerNum)const noexcept;
+    bool                pinThread(int node)const noexcept;
+    int                 pinNextThread()noexcept;
+
+    template<typename T>
+    vector<T>           replicate(const T &original)const;
+};
+
+/// @brief Copy data once per node, each copy made by a thread pinned to its node.
+/// @param original Data to be copied, must be deep-copy assignable.
+/// @return Copies indexed by node.
+template<typename T>
+vector<T>
+NumaTopology::replicate(const T &original)const
+{
+    vector<T>           replicas(nodeNum());
+    vector<std::thread> threadPool;
+    for (int node = 0; node < nodeNum(); node++)
+    {
+        threadPool.emplace_back([&, node]()
+        {
+            pinThread(node);
+            replicas[node] = original;      // Pages are first touched on this node.
+        });
+    }
+    for(auto &th : threadPool) th.join();
+    return replicas;
+}
@@ -0,0 +1,122 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "PackedData.h"
+#include <algorithm>
+
+PackedData::PackedData()noexcept:
+_inputSize(0),
+_stride(0),
+_sampleNum(0)
+{
+}
+
+PackedData::PackedData(size_t sampleNum, int inputSize):
+PackedData()
+{
+    resize(sampleNum, inputSize);
+}
+
+/// @brief Reshape the slab, content of samples is unspecified until packed.
+/// @param sampleNum Number of samples.
+/// @param inputSize Literals per sample.
+void
+PackedData::resize(size_t sampleNum, int inputSize)
+{
+    _inputSize = inputSize;
+    _stride = inputSize/16 + (inputSize%16==0? 0:1);
+    _sampleNum = sampleNum;
+    _blocks.resize(sampleNum * _stride);
+    _blocks.shrink_to_fit();
+}
+
+/// @brief Pack one row of 32bit literals into sample i.
+/// @param i Sample index.
+/// @param row Literals of _inputSize elements.
+void
+PackedData::packRow(size_t i, const int *row)noexcept
+{
+    __m512i     *target = (*this)[i];
+    const int   remainder = _inputSize%16;
+    for (int b = 0; b < _stride; b++)
+    {
+        if((b == _stride - 1) && (remainder != 0))[[unlikely]]     // Never read past the row.
+        {
+            target[b] = _mm512_maskz_loadu_epi32(_mm512_int2mask((1<<remainder) - 1), row + b*16);
+        }
+        else
+        {
+            target[b] = _mm512_loadu_si512(row + b*16);
+        }
+    }
+}
+
+/// @brief Pack one row of byte literals into sample i.
+/// @param i Sample index.
+/// @param row Literals of _inputSize bytes.
+void
+PackedData::packRow(size_t i, const uint8_t *row)noexcept
+{
+    __m512i     *target = (*this)[i];
+    const int   remainder = _inputSize%16;
+    for (int b = 0; b < _stride; b++)
+    {
+        if((b == _stride - 1) && (remainder != 0))[[unlikely]]
+        {
+            alignas(16) uint8_t tail[16] = {0};
+            std::copy(row + b*16, row + b*16 + remainder, tail);
+            target[b] = _mm512_cvtepu8_epi32(_mm_load_si128((const __m128i*)tail));
+        }
+        else
+        {
+            target[b] = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)(row + b*16)));
+        }
+    }
+}
+
+/// @brief Pack one bit-packed row into sample i.
+/// @param i Sample index.
+/// @param words Bit-packed literals, bit k of the row is literal k.
+void
+PackedData::packBits(size_t i, const uint64_t *words)noexcept
+{
+    unpackBits(words, _inputSize, (*this)[i]);
+}
+
+/// @brief Expand a bit-packed sample into blocks of 32bit literals.
+/// @param words Sample bits, bit i represent literal i.
+/// @param inputSize Literals per sample.
+/// @param blocks Destination of unpacked blocks.
+void
+PackedData::unpackBits(const uint64_t *words, int inputSize, __m512i *blocks)noexcept
+{
+    const __m512i   ones = _mm512_set1_epi32(1);
+    const int       blockNum = inputSize/16 + (inputSize%16==0? 0:1);
+    const int       remainder = inputSize%16;
+    for (int b = 0; b < blockNum; b++)
+    {
+        int bits = (words[b/4] >> (16 * (b%4))) & 0xFFFF;
+        if((b == blockNum - 1) && (remainder != 0)) bits &= (1<<remainder) - 1;
+        blocks[b] = _mm512_maskz_mov_epi32(_mm512_int2mask(bits), ones);
+    }
+}
@@ -0,0 +1,58 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+using std::vector;
+
+/// @brief Samples packed into one 64-byte aligned slab, every sample takes a fixed
+///        stride of __m512i blocks holding 16 literals each, tail literals are zero.
+class PackedData{
+private:
+    int                 _inputSize;
+    int                 _stride;        // Blocks per sample.
+    size_t              _sampleNum;
+    vector<__m512i>     _blocks;        // Row-major ( _sampleNum * _stride ), aligned by allocator of __m512i.
+
+public:
+    PackedData()noexcept;
+    PackedData(size_t sampleNum, int inputSize);
+
+    void            resize(size_t sampleNum, int inputSize);
+    void            packRow(size_t i, const int *row)noexcept;
+    void            packRow(size_t i, const uint8_t *row)noexcept;
+    void            packBits(size_t i, const uint64_t *words)noexcept;
+
+    __m512i*        operator[](size_t i)noexcept        {return _blocks.data() + i * _stride;}
+    const __m512i*  operator[](size_t i)const noexcept  {return _blocks.data() + i * _stride;}
+    size_t          size()const noexcept                {return _sampleNum;}
+    bool            empty()const noexcept               {return _sampleNum == 0;}
+    int             stride()const noexcept              {return _stride;}
+    int             inputSize()const noexcept           {return _inputSize;}
+    size_t          bytes()const noexcept               {return _blocks.size() * sizeof(__m512i);}
+
+    static void     unpackBits(const uint64_t *words, int inputSize, __m512i *blocks)noexcept;
+};
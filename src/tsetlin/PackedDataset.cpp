@@ -0,0 +1,99 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "PackedDataset.h"
+
+PackedDataset::PackedDataset()noexcept:
+_inputSize(0),
+_outputSize(0)
+{
+}
+
+/// @brief Pack both splits of a dataset.
+/// @param data Dataset divided by parseAndDivide, responses are one-hot.
+PackedDataset::PackedDataset(const dataset &data):
+_inputSize(data.trainData.empty()? 0 : data.trainData[0].size()),
+_outputSize(data.trainResponse.empty()? 0 : data.trainResponse[0].size())
+{
+    if( !integrityCheck(data.trainData, data.trainResponse) ||
+        !integrityCheck(data.testData, data.testResponse)) {throw;}
+    packSplit(data.trainData, data.trainResponse, _train);
+    packSplit(data.testData, data.testResponse, _validation);
+}
+
+/// @brief Check that every row and response of a split has the width of the dataset.
+/// @param data 2D vector shaped in ( sampleNum * _inputSize )
+/// @param response 2D vector shaped in ( sampleNum * _outputSize )
+/// @return Result of integrity check procedure.
+bool
+PackedDataset::integrityCheck(  const vector<vector<int>> &data,
+                                const vector<vector<int>> &response)noexcept
+{
+    bool isRightLength = (_inputSize > 0) && (_outputSize > 0) && (data.size() == response.size());
+    for (int i = 0; i < data.size() && isRightLength; i++)
+    {
+        isRightLength = (data[i].size() == _inputSize) && (response[i].size() == _outputSize) &&
+                        (TsetlinMachine::hotIndex(response[i]) >= 0);
+    }
+    if (!isRightLength)
+    {
+        std::cout<<"Data failed integrity check."<<std::endl;
+    }
+    return isRightLength;
+}
+
+/// @brief Pack one split into a slab and reduce one-hot responses to class indices.
+/// @param data 2D vector shaped in ( sampleNum * _inputSize )
+/// @param response 2D vector shaped in ( sampleNum * _outputSize )
+/// @param target Packed data and labels.
+void
+PackedDataset::packSplit(   const vector<vector<int>> &data,
+                            const vector<vector<int>> &response,
+                            TsetlinMachine::PackedSet &target)noexcept
+{
+    target.data.resize(data.size(), _inputSize);
+    target.labels.resize(data.size());
+    for (int i = 0; i < data.size(); i++)
+    {
+        target.data.packRow(i, data[i].data());
+        target.labels[i] = TsetlinMachine::hotIndex(response[i]);
+    }
+}
+
+/// @brief Pack a dataset once and hand out a read-only reference counted handle.
+/// @param data Dataset divided by parseAndDivide.
+/// @return Handle shared by all machines that load it.
+PackedDataset::Handle
+PackedDataset::share(const dataset &data)
+{
+    return std::make_shared<const PackedDataset>(data);
+}
+
+/// @brief Freeze an already packed dataset, e.g. a NUMA node-local replica.
+/// @param packed Dataset moved into the handle.
+/// @return Handle shared by all machines that load it.
+PackedDataset::Handle
+PackedDataset::share(PackedDataset &&packed)
+{
+    return std::make_shared<const PackedDataset>(std::move(packed));
+}
@@ -0,0 +1,60 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include <memory>
+#include "io.h"
+#include "TsetlinMachine.h"
+using std::vector;
+
+/// @brief Train and validation splits of a dataset packed once and never modified afterwards.
+///        Handles are reference counted, any number of machines may train or predict on
+///        one dataset concurrently, memory and packing cost are paid once per dataset.
+class PackedDataset{
+public:
+    using Handle = std::shared_ptr<const PackedDataset>;
+
+private:
+    int                         _inputSize;
+    int                         _outputSize;
+    TsetlinMachine::PackedSet   _train;
+    TsetlinMachine::PackedSet   _validation;
+
+    bool    integrityCheck(const vector<vector<int>> &data, const vector<vector<int>> &response)noexcept;
+    void    packSplit(  const vector<vector<int>> &data,
+                        const vector<vector<int>> &response,
+                        TsetlinMachine::PackedSet &target)noexcept;
+
+public:
+    PackedDataset()noexcept;
+    PackedDataset(const dataset &data);
+
+    static Handle   share(const dataset &data);
+    static Handle   share(PackedDataset &&packed);
+
+    const TsetlinMachine::PackedSet&    train()const noexcept       {return _train;}
+    const TsetlinMachine::PackedSet&    validation()const noexcept  {return _validation;}
+    int                                 inputSize()const noexcept   {return _inputSize;}
+    int                                 outputSize()const noexcept  {return _outputSize;}
+    size_t                              bytes()const noexcept       {return _train.data.bytes() + _validation.data.bytes();}
+};
@@ -0,0 +1,237 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "RegressionTsetlinMachine.h"
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+
+RegressionTsetlinMachine::RegressionTsetlinMachine(MachineArgs args)noexcept:
+_inputSize(args.inputSize),
+_clauseNum(args.clauseNum),
+_T(args.T),
+_dropoutRatio(args.dropoutRatio),
+_myArgs(args),
+_low(0),
+_high(1),
+_clauses(ClauseArena::ArenaArgs{args.clauseNum, args.inputSize, args.hugePage})
+{
+    if(args.seed != 0)
+    {
+        std::seed_seq sequence{(uint32_t)args.seed, (uint32_t)(args.seed >> 32)};  // A raw seed loses its low bits in pcg64_fast.
+        _rng.seed(sequence);
+    }
+    else
+    {
+        pcg_extras::seed_seq_from<std::random_device> seed_source;
+        _rng.seed(seed_source);
+    }
+
+    for (int i = 0; i < _clauseNum; i++)
+    {
+        Clause(_clauses, i).initialize(args.sLow + i * (args.sHigh - args.sLow)/((double)_clauseNum));
+    }
+    _inputMask.resize(_clauses.blockNum(), 0);
+    _inputMaskInverse.resize(_clauses.blockNum(), 0);
+}
+
+RegressionTsetlinMachine::RegressionTsetlinMachine(model &savedModel)noexcept:
+RegressionTsetlinMachine(savedModel.modelArgs)
+{
+    importModel(savedModel);
+}
+
+/// @brief Check the integrity of argument 'data'.
+/// @param data Input unknown size 2D vector.
+/// @return Result of integrity check procedure.
+bool
+RegressionTsetlinMachine::dataIntegrityCheck(const vector<vector<int>> &data)
+{
+    bool isZeroSize = (data.size()==0);
+    bool isCorrectLength = true;
+    for (int i = 0; i < data.size(); i++)
+    {
+        isCorrectLength &= (data[i].size() == _inputSize);
+        if(!isCorrectLength)break;
+    }
+    bool result = (!isZeroSize) && (isCorrectLength);
+    if (!result)
+    {
+        std::cout<<"Data failed integrity check."<<std::endl;
+    }
+    return result;
+}
+
+/// @brief Count fired clauses on a single packed sample.
+/// @param datavec A single packed sample.
+/// @return Number of clauses voting, in [0, clauseNum].
+int
+RegressionTsetlinMachine::forward(const __m512i *datavec)noexcept
+{
+    _clauses.maskInput(datavec, _inputMask.data(), _inputMaskInverse.data());
+    int sum = 0;
+    for (int i = 0; i < _clauseNum; i++)
+    {
+        sum += Clause(_clauses, i).vote(_inputMask.data(), _inputMaskInverse.data());
+    }
+    return sum;
+}
+
+/// @brief Push vote count towards target, feedback possibility is proportional to the error.
+/// @param target Response of current sample rescaled into [0, T].
+/// @param voteSum Vote count given by forward.
+void
+RegressionTsetlinMachine::backward(double target, int voteSum)noexcept
+{
+    std::uniform_real_distribution<double> d(0.0, 1.0);
+    const double    error = std::min<double>(_T, voteSum) - target;
+    const double    probability = std::abs(error) / _T;
+    for (int i = 0; i < _clauseNum; i++)
+    {
+        if(d(_rng) >= probability) continue;
+        if(d(_rng) < _dropoutRatio) continue;       // Random dropout some clauses.
+        Clause clause(_clauses, i);
+        if(error < 0)   // Too few votes, make clauses recognize this sample.
+        {
+            clause.feedbackTypeI(_inputMask.data(), _inputMaskInverse.data());
+        }
+        else            // Too many votes, make fired clauses reject this sample.
+        {
+            clause.feedbackTypeII(_inputMask.data(), _inputMaskInverse.data());
+        }
+    }
+}
+
+/// @brief Perform data integrity check, rescale responses and load into shared vector.
+/// @param data 2D vector shaped in ( sampleNum * _inputSize )
+/// @param response Continuous responses shaped in ( sampleNum )
+void
+RegressionTsetlinMachine::load( vector<vector<int>> &data,
+                                vector<double> &response)
+{
+    bool isRightResponse = (response.size() == data.size());
+    if(!isRightResponse) std::cout<<"Response failed integrity check."<<std::endl;
+    if(!dataIntegrityCheck(data) || !isRightResponse) {throw;return;}
+
+    auto [low, high] = std::minmax_element(response.begin(), response.end());
+    _low = *low;
+    _high = (*high > *low)? *high : *low + 1;      // Constant response still maps to a valid range.
+    _sharedData.resize(data.size(), _inputSize);
+    _targets.resize(data.size());
+    for (int i = 0; i < data.size(); i++)
+    {
+        _sharedData.packRow(i, data[i].data());
+        _targets[i] = (response[i] - _low) / (_high - _low) * _T;
+    }
+    _sampleOrder.resize(data.size());
+    std::iota(_sampleOrder.begin(), _sampleOrder.end(), 0);
+}
+
+/// @brief Train this Tsetlin machine using loaded data.
+/// @param epoch Max count of repeat training time.
+void
+RegressionTsetlinMachine::train(int epoch)
+{
+    for (int e = 0; e < epoch; e++)
+    {
+        if(_myArgs.shuffle) std::shuffle(_sampleOrder.begin(), _sampleOrder.end(), _rng);
+        for(auto idx : _sampleOrder)
+        {
+            backward(_targets[idx], forward(_sharedData[idx]));
+        }
+    }
+}
+
+/// @brief Load data and predict continuous response using trained tsetlin machine.
+/// @param data 2D vector shaped in ( sampleNum * _inputSize )
+/// @return Predicted responses shaped in ( sampleNum ), within range seen by load.
+vector<double>
+RegressionTsetlinMachine::loadAndPredict(vector<vector<int>> &data)
+{
+    if( !dataIntegrityCheck(data)) throw;
+    vector<double>  result(data.size(), 0);
+    PackedData      packed(1, _inputSize);      // Scratch row reused by every sample.
+    for (int sampleIdx = 0; sampleIdx < data.size(); sampleIdx++)
+    {
+        packed.packRow(0, data[sampleIdx].data());
+        const int       voteSum = std::min(_T, forward(packed[0]));
+        result[sampleIdx] = _low + voteSum * (_high - _low) / _T;
+    }
+    return result;
+}
+
+/// @brief Mean absolute error of prediction, in unit of response.
+/// @param data 2D vector shaped in ( sampleNum * _inputSize )
+/// @param response Continuous responses shaped in ( sampleNum )
+/// @return Mean absolute error.
+double
+RegressionTsetlinMachine::meanAbsoluteError(vector<vector<int>> &data, vector<double> &response)
+{
+    if(response.size() != data.size())
+    {
+        std::cout<<"Response failed integrity check."<<std::endl;
+        throw;
+    }
+    vector<double>  prediction = loadAndPredict(data);
+    double          error = 0;
+    for (int i = 0; i < data.size(); i++)
+    {
+        error += std::abs(prediction[i] - response[i]);
+    }
+    return error / data.size();
+}
+
+/// @brief Import clause states and response range of a saved model.
+/// @param targetModel Model exported by exportModel.
+void
+RegressionTsetlinMachine::importModel(model &targetModel)
+{
+    if(targetModel.clauses.size() != _clauseNum)
+    {
+        std::cout<<"Your Tsetlin Machine model failed integrity check!"<<std::endl;
+        throw;
+    }
+    for (int i = 0; i < _clauseNum; i++)
+    {
+        Clause(_clauses, i).importModel(targetModel.clauses[i]);
+    }
+    _low = targetModel.low;
+    _high = targetModel.high;
+}
+
+/// @brief Export current model.
+/// @return Clause states, response range and arguments.
+RegressionTsetlinMachine::model
+RegressionTsetlinMachine::exportModel()
+{
+    model result;
+    result.modelArgs = _myArgs;
+    result.low = _low;
+    result.high = _high;
+    result.clauses.resize(_clauseNum);
+    for (int i = 0; i < _clauseNum; i++)
+    {
+        result.clauses[i] = Clause(_clauses, i).exportModel();
+    }
+    return result;
+}
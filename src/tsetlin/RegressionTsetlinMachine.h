@@ -0,0 +1,87 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include "TsetlinMachine.h"
+using std::vector;
+using std::string;
+
+/// @brief Regression Tsetlin machine, one clause bank whose vote count
+///        is mapped linearly onto the range of a continuous response.
+class RegressionTsetlinMachine{
+public:
+    struct MachineArgs
+    {
+        int             inputSize;
+        int             clauseNum;
+        int             T;                  // Vote count mapped to the largest response.
+        double          sLow, sHigh;
+        double          dropoutRatio;
+        bool            shuffle = true;     // Visit samples in a fresh random order every epoch.
+        uint64_t        seed = 0;           // Seed of shuffling and feedback stream, 0 means seeded from random device.
+        bool            hugePage = false;   // Back clause arena with transparent huge pages.
+    };
+    struct model
+    {
+        MachineArgs             modelArgs;
+        double                  low, high;  // Response range seen by load.
+        vector<vector<int>>     clauses;    // Arranged in size of clauseNum * (literalNum * 2)
+        model(){}
+    };
+
+private:
+    const int                   _inputSize;
+    const int                   _clauseNum;
+    const int                   _T;
+    const double                _dropoutRatio;
+    const MachineArgs           _myArgs;
+    double                      _low, _high;
+
+    ClauseArena                 _clauses;
+    vector<__mmask16>           _inputMask;
+    vector<__mmask16>           _inputMaskInverse;
+
+    PackedData                  _sharedData;        // One aligned slab of all loaded samples.
+    vector<double>              _targets;       // Responses rescaled into [0, T].
+    vector<int>                 _sampleOrder;
+    pcg64_fast                  _rng;
+
+    bool    dataIntegrityCheck(const vector<vector<int>> &data);
+
+    int     forward(const __m512i *datavec)noexcept;
+    void    backward(double target, int voteSum)noexcept;
+
+public:
+    RegressionTsetlinMachine(MachineArgs args)noexcept;
+    RegressionTsetlinMachine(model &savedModel)noexcept;
+
+    void                load(   vector<vector<int>> &data,
+                                vector<double> &response);
+    void                train(int epoch);
+
+    vector<double>      loadAndPredict(vector<vector<int>> &data);
+    double              meanAbsoluteError(vector<vector<int>> &data, vector<double> &response);
+
+    void                importModel(model &targetModel);
+    model               exportModel();
+};
@@ -0,0 +1,354 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "SparseTsetlinMachine.h"
+#include "TsetlinMachine.h"
+#include <numeric>
+#include <algorithm>
+
+SparseTsetlinMachine::SparseTsetlinMachine(MachineArgs args, vector<string> tierTags):
+_inputSize(args.inputSize),
+_outputSize(args.outputSize),
+_clausePerOutput(args.clausePerOutput),
+_clauseNum(args.outputSize * 2 * args.clausePerOutput),
+_T(args.T),
+_dropoutRatio(args.dropoutRatio),
+_myArgs(args),
+_tierTags(tierTags)
+{
+    if(args.stateFloor >= 0)    // Untracked literals must rest excluded, inclusion starts at state 0.
+    {
+        std::cout<<"stateFloor must be negative, untracked literals would count as included."<<std::endl;
+        throw;
+    }
+    if(args.seed != 0)
+    {
+        std::seed_seq sequence{(uint32_t)args.seed, (uint32_t)(args.seed >> 32)};  // A raw seed loses its low bits in pcg64_fast.
+        _rng.seed(sequence);
+    }
+    else
+    {
+        pcg_extras::seed_seq_from<std::random_device> seed_source;
+        _rng.seed(seed_source);
+    }
+
+    _literals.resize(_clauseNum);
+    _states.resize(_clauseNum);
+    _included.resize(_clauseNum);
+    _sInv.resize(_clauseNum, 0);
+    _votes.resize(_clauseNum, 0);
+    for (int c = 0; c < _clauseNum; c++)
+    {
+        const int i = c % _clausePerOutput;
+        _sInv[c] = 1.0 / (args.sLow + i * (args.sHigh - args.sLow)/((double)_clausePerOutput));
+    }
+    _activeBits.resize(_inputSize/64 + 1, 0);
+}
+
+/// @brief Check that every sample is a strictly increasing list of valid literal indices.
+/// @param data Active literal lists of unknown samples.
+/// @return Result of integrity check procedure.
+bool
+SparseTsetlinMachine::dataIntegrityCheck(const vector<vector<int>> &data)
+{
+    bool isZeroSize = (data.size()==0);
+    bool isSorted = true;
+    for (int i = 0; i < data.size() && isSorted; i++)
+    {
+        for (int k = 0; k < data[i].size(); k++)
+        {
+            isSorted &= (data[i][k] >= 0) && (data[i][k] < _inputSize);
+            isSorted &= (k == 0) || (data[i][k-1] < data[i][k]);
+        }
+    }
+    bool result = (!isZeroSize) && (isSorted);
+    if (!result)
+    {
+        std::cout<<"Data failed integrity check."<<std::endl;
+    }
+    return result;
+}
+
+/// @brief Set or clear bits of active literals in the bitmap of current sample.
+/// @param active Sorted active literal indices.
+/// @param activeNum Number of active literals.
+/// @param value Whether to set or clear.
+void
+SparseTsetlinMachine::setActive(const int *active, int activeNum, bool value)noexcept
+{
+    for (int k = 0; k < activeNum; k++)
+    {
+        const uint64_t bit = (uint64_t)1 << (active[k] % 64);
+        if(value)   _activeBits[active[k] / 64] |= bit;
+        else        _activeBits[active[k] / 64] &= ~bit;
+    }
+}
+
+/// @brief Rebuild list of included literals after states changed.
+/// @param clause Global clause index.
+void
+SparseTsetlinMachine::refreshInclusion(int clause)noexcept
+{
+    vector<int> &included = _included[clause];
+    included.clear();
+    for (int k = 0; k < _literals[clause].size(); k++)
+    {
+        if(_states[clause][k] >= 0) included.push_back(_literals[clause][k]);
+    }
+}
+
+/// @brief Vote of one clause against the bitmap of current sample.
+/// @param clause Global clause index.
+/// @param isTraining Empty clauses vote only while training.
+/// @return Vote result, 0 or 1.
+int
+SparseTsetlinMachine::vote(int clause, bool isTraining)noexcept
+{
+    const vector<int> &included = _included[clause];
+    int result = (isTraining || !included.empty())? 1:0;
+    for (int k = 0; k < included.size() && result; k++)
+    {
+        result = (_activeBits[included[k] / 64] >> (included[k] % 64)) & 1;
+    }
+    _votes[clause] = result;
+    return result;
+}
+
+/// @brief Class sum of one output on current sample.
+/// @param output Index of output.
+/// @param isTraining Empty clauses vote only while training.
+/// @return Votes of positive clauses minus votes of negative clauses.
+int
+SparseTsetlinMachine::forward(int output, bool isTraining)noexcept
+{
+    const int   first = output * 2 * _clausePerOutput;
+    int         sum = 0;
+    for (int i = 0; i < _clausePerOutput; i++)
+    {
+        sum += vote(first + i, isTraining);
+        sum -= vote(first + _clausePerOutput + i, isTraining);
+    }
+    return sum;
+}
+
+/// @brief Type I feedback by merging tracked literals with active literals of the sample.
+/// @param clause Global clause index.
+/// @param active Sorted active literal indices of current sample.
+/// @param activeNum Number of active literals.
+void
+SparseTsetlinMachine::feedbackTypeI(int clause, const int *active, int activeNum)noexcept
+{
+    std::uniform_real_distribution<double> d(0.0, 1.0);
+    const double    sInv = _sInv[clause];
+    vector<int>     &literals = _literals[clause];
+    vector<int>     &states = _states[clause];
+    _mergedLiterals.clear();
+    _mergedStates.clear();
+    auto keep = [&](int literal, int state)
+    {
+        if(state > _myArgs.stateFloor)
+        {
+            _mergedLiterals.push_back(literal);
+            _mergedStates.push_back(state);
+        }
+    };
+
+    if(!_votes[clause])     // Not fired, every tracked literal is forgotten a bit.
+    {
+        for (int k = 0; k < literals.size(); k++)
+        {
+            keep(literals[k], states[k] - (d(_rng) < sInv));
+        }
+    }
+    else                    // Fired, memorize active literals and forget inactive ones.
+    {
+        int k = 0, a = 0;
+        while(k < literals.size() || a < activeNum)
+        {
+            if(a == activeNum || (k < literals.size() && literals[k] < active[a]))
+            {
+                keep(literals[k], states[k] - (d(_rng) < sInv));
+                k++;
+            }
+            else if(k == literals.size() || active[a] < literals[k])
+            {
+                if(d(_rng) >= sInv) keep(active[a], _myArgs.stateFloor + 1);    // Untracked literals rest at the floor.
+                a++;
+            }
+            else
+            {
+                keep(literals[k], states[k] + (d(_rng) >= sInv));
+                k++; a++;
+            }
+        }
+    }
+    literals.swap(_mergedLiterals);
+    states.swap(_mergedStates);
+    refreshInclusion(clause);
+}
+
+/// @brief Type II feedback, include tracked literals that are inactive in this sample.
+/// @param clause Global clause index.
+/// @param active Sorted active literal indices of current sample.
+/// @param activeNum Number of active literals.
+void
+SparseTsetlinMachine::feedbackTypeII(int clause, const int *active, int activeNum)noexcept
+{
+    if(!_votes[clause]) return;
+    vector<int>     &literals = _literals[clause];
+    vector<int>     &states = _states[clause];
+    bool            isChanged = false;
+    for (int k = 0, a = 0; k < literals.size(); k++)
+    {
+        while(a < activeNum && active[a] < literals[k]) a++;
+        if((a < activeNum && active[a] == literals[k]) || states[k] >= 0) continue;
+        states[k]++;
+        isChanged |= (states[k] >= 0);
+    }
+    if(isChanged) refreshInclusion(clause);
+}
+
+/// @brief Feedback of one output.
+/// @param output Index of output.
+/// @param response Target response of this output, 0 or 1.
+/// @param classSum Class sum given by forward.
+/// @param active Sorted active literal indices of current sample.
+/// @param activeNum Number of active literals.
+void
+SparseTsetlinMachine::backward(int output, int response, int classSum, const int *active, int activeNum)noexcept
+{
+    std::uniform_real_distribution<double> d(0.0, 1.0);
+    const int       first = output * 2 * _clausePerOutput;
+    const int       clampedSum = std::min(_T, std::max(-_T, classSum));
+    const double    probability = (response == 1)?  (_T - clampedSum) / (2.0 * _T) :
+                                                    (_T + clampedSum) / (2.0 * _T);
+    for (int i = 0; i < _clausePerOutput; i++)
+    {
+        if(d(_rng) >= probability) continue;
+        if(d(_rng) < _dropoutRatio) continue;       // Random dropout some clauses.
+        const int positive = first + i;
+        const int negative = first + _clausePerOutput + i;
+        feedbackTypeI((response == 1)? positive : negative, active, activeNum);
+        feedbackTypeII((response == 1)? negative : positive, active, activeNum);
+    }
+}
+
+/// @brief Perform data integrity check and load active literal lists into compressed rows.
+/// @param activeLiterals Sorted active literal indices of each sample.
+/// @param response 2D vector shaped in ( sampleNum * _outputSize )
+void
+SparseTsetlinMachine::load( vector<vector<int>> &activeLiterals,
+                            vector<vector<int>> &response)
+{
+    bool isRightResponse = (response.size() == activeLiterals.size()) &&
+                           (response.size() > 0) &&
+                           (response[0].size() == _outputSize);
+    for (int i = 0; i < response.size() && isRightResponse; i++)
+    {
+        isRightResponse &= (response[i].size() == _outputSize) && (TsetlinMachine::hotIndex(response[i]) >= 0);
+    }
+    if(!isRightResponse) std::cout<<"Response failed integrity check."<<std::endl;
+    if(!dataIntegrityCheck(activeLiterals) || !isRightResponse) {throw;return;}
+
+    _offsets.assign(1, 0);
+    _sharedIndices.clear();
+    _labels.resize(activeLiterals.size());
+    for (int i = 0; i < activeLiterals.size(); i++)
+    {
+        _sharedIndices.insert(_sharedIndices.end(), activeLiterals[i].begin(), activeLiterals[i].end());
+        _offsets.push_back(_sharedIndices.size());
+        _labels[i] = TsetlinMachine::hotIndex(response[i]);
+    }
+    _sharedIndices.shrink_to_fit();
+    _sampleOrder.resize(activeLiterals.size());
+    std::iota(_sampleOrder.begin(), _sampleOrder.end(), 0);
+}
+
+/// @brief Train this Tsetlin machine using loaded data.
+/// @param epoch Max count of repeat training time.
+void
+SparseTsetlinMachine::train(int epoch)
+{
+    for (int e = 0; e < epoch; e++)
+    {
+        if(_myArgs.shuffle) std::shuffle(_sampleOrder.begin(), _sampleOrder.end(), _rng);
+        for(auto idx : _sampleOrder)
+        {
+            const int   *active = _sharedIndices.data() + _offsets[idx];
+            const int   activeNum = _offsets[idx + 1] - _offsets[idx];
+            setActive(active, activeNum, true);
+            for (int j = 0; j < _outputSize; j++)
+            {
+                backward(j, (_labels[idx] == j)? 1:0, forward(j, true), active, activeNum);
+            }
+            setActive(active, activeNum, false);
+        }
+    }
+}
+
+/// @brief Load data and predict response using trained tsetlin machine.
+/// @param activeLiterals Sorted active literal indices of each sample.
+/// @return 2D vector shaped in ( sampleNum * _outputSize )
+vector<vector<int>>
+SparseTsetlinMachine::loadAndPredict(vector<vector<int>> &activeLiterals)
+{
+    if( !dataIntegrityCheck(activeLiterals)) throw;
+    vector<vector<int>> result(activeLiterals.size(), vector<int>(_outputSize,0));
+    vector<int>         classSums(_outputSize, 0);
+    for (int sampleIdx = 0; sampleIdx < activeLiterals.size(); sampleIdx++)
+    {
+        const vector<int> &active = activeLiterals[sampleIdx];
+        setActive(active.data(), active.size(), true);
+        for (int j = 0; j < _outputSize; j++)
+        {
+            classSums[j] = forward(j, false);
+        }
+        setActive(active.data(), active.size(), false);
+        int competitorIdx = TsetlinMachine::argmax(classSums.data(), _outputSize);
+        result[sampleIdx][competitorIdx] = 1;
+    }
+    return result;
+}
+
+/// @brief Count literals tracked by all clauses, i.e. memory footprint of clause states.
+/// @return Number of tracked literals.
+size_t
+SparseTsetlinMachine::trackedNum()const noexcept
+{
+    size_t result = 0;
+    for(auto &literals : _literals) result += literals.size();
+    return result;
+}
+
+/// @brief Export current model.
+/// @return Tracked literals and their states of every clause, and arguments.
+SparseTsetlinMachine::model
+SparseTsetlinMachine::exportModel()
+{
+    model result;
+    result.modelArgs = _myArgs;
+    result.tierTags = _tierTags;
+    result.literals = _literals;
+    result.states = _states;
+    return result;
+}
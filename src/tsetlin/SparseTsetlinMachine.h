@@ -0,0 +1,105 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include <vector>
+#include <string>
+#include <random>
+#include <iostream>
+#include "pcg_random.hpp"
+using std::vector;
+using std::string;
+
+/// @brief Tsetlin machine over very wide and sparse binary inputs.
+///        Samples are sorted lists of active literal indices, clauses only track
+///        literals they have met in a recognized sample and use positive literals only.
+///        Untracked literals rest excluded at stateFloor, so cost scales with active and tracked literals.
+class SparseTsetlinMachine{
+public:
+    struct MachineArgs
+    {
+        int             inputSize;
+        int             outputSize;
+        int             clausePerOutput;
+        int             T;
+        double          sLow, sHigh;
+        double          dropoutRatio;
+        int             stateFloor = -16;   // State of untracked literals, tracked ones decaying to it are forgotten.
+        bool            shuffle = true;     // Visit samples in a fresh random order every epoch.
+        uint64_t        seed = 0;           // Seed of shuffling and feedback stream, 0 means seeded from random device.
+    };
+    struct model
+    {
+        MachineArgs             modelArgs;
+        vector<string>          tierTags;
+        vector<vector<int>>     literals;   // Tracked literal indices of each clause, outputSize * (2 * clausePerOutput) rows.
+        vector<vector<int>>     states;     // State of each tracked literal, included when not negative.
+        model(){}
+    };
+
+private:
+    const int                   _inputSize;
+    const int                   _outputSize;
+    const int                   _clausePerOutput;
+    const int                   _clauseNum;         // Clauses of all outputs, positive ones first within each output.
+    const int                   _T;
+    const double                _dropoutRatio;
+    const MachineArgs           _myArgs;
+    const vector<string>        _tierTags;
+
+    vector<vector<int>>         _literals;          // Sorted tracked literal indices of each clause.
+    vector<vector<int>>         _states;
+    vector<vector<int>>         _included;          // Sorted indices of included literals, used for evaluation.
+    vector<double>              _sInv;
+    vector<int>                 _votes;
+    vector<int>                 _mergedLiterals;    // Scratch of feedback merging.
+    vector<int>                 _mergedStates;
+
+    vector<int>                 _sharedIndices;     // Active literals of all samples, compressed rows.
+    vector<size_t>              _offsets;           // Row i is [_offsets[i], _offsets[i+1]).
+    vector<int>                 _labels;
+    vector<int>                 _sampleOrder;
+    vector<uint64_t>            _activeBits;        // Bitmap of current sample, only active words are touched.
+    pcg64_fast                  _rng;
+
+    bool    dataIntegrityCheck(const vector<vector<int>> &data);
+    void    setActive(const int *active, int activeNum, bool value)noexcept;
+    int     vote(int clause, bool isTraining)noexcept;
+    int     forward(int output, bool isTraining)noexcept;
+    void    backward(int output, int response, int classSum, const int *active, int activeNum)noexcept;
+    void    feedbackTypeI(int clause, const int *active, int activeNum)noexcept;
+    void    feedbackTypeII(int clause, const int *active, int activeNum)noexcept;
+    void    refreshInclusion(int clause)noexcept;
+
+public:
+    SparseTsetlinMachine(MachineArgs args, vector<string> tierTags);
+
+    void                load(   vector<vector<int>> &activeLiterals,
+                                vector<vector<int>> &response);
+    void                train(int epoch);
+
+    vector<vector<int>> loadAndPredict(vector<vector<int>> &activeLiterals);
+
+    size_t              trackedNum()const noexcept;
+    model               exportModel();
+};
@@ -0,0 +1,213 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "TsetlinCascade.h"
+#include <limits>
+#include <numeric>
+#include <algorithm>
+
+TsetlinCascade::TsetlinCascade( TsetlinMachine::model &smallModel,
+                                TsetlinMachine::model &largeModel):
+_small(std::make_unique<TsetlinMachine>(smallModel)),
+_large(std::make_unique<TsetlinMachine>(largeModel)),
+_threshold(std::numeric_limits<double>::infinity()),
+_requestNum(0),
+_escalatedNum(0)
+{
+    bool isCompatible = (_small->inputSize() == _large->inputSize()) &&
+                        (_small->outputSize() == _large->outputSize()) &&
+                        (_small->args().inputRemap == _large->args().inputRemap) &&   // Packed data reads same columns.
+                        (_small->args().originalInputSize == _large->args().originalInputSize);
+    if(!isCompatible)
+    {
+        std::cout<<"Cascaded machines failed integrity check, shapes differ."<<std::endl;
+        throw;
+    }
+}
+
+/// @brief Winner of vote sums by the rule of TsetlinMachine::classify and its lead over the runner-up.
+///        Class 0 wins unless another sum is positive, ties go to lower index.
+/// @param sums Vote sums of every class.
+/// @param outputSize Number of classes.
+/// @param margin Output lead of winner over runner-up, in votes.
+/// @return Index of winning class.
+int
+TsetlinCascade::decide(const int *sums, int outputSize, int &margin)noexcept
+{
+    auto score = [&](int j){return (j == 0)? std::max(sums[0], 0) : sums[j];};
+    int winner = 0;
+    for (int j = 1; j < outputSize; j++)
+    {
+        if(score(j) > score(winner)) winner = j;
+    }
+    int runnerUp = std::numeric_limits<int>::min();
+    for (int j = 0; j < outputSize; j++)
+    {
+        if(j != winner) runnerUp = std::max(runnerUp, score(j));
+    }
+    margin = (outputSize > 1)? score(winner) - runnerUp : score(winner);
+    return winner;
+}
+
+/// @brief Classes and normalized vote margins given by the small machine.
+/// @param mdata Packed samples.
+/// @param classes Output class of each sample.
+/// @param margins Output margin of each sample, divided by clauses per output like Prediction::confidence.
+void
+TsetlinCascade::scoreSmall( const PackedData &mdata,
+                            vector<int> &classes,
+                            vector<double> &margins)
+{
+    const int   outputSize = _small->outputSize();
+    vector<int> sums(mdata.size() * outputSize, 0);
+    _small->score(mdata, sums.data());
+    classes.resize(mdata.size());
+    margins.resize(mdata.size());
+    for (int i = 0; i < mdata.size(); i++)
+    {
+        int margin = 0;
+        classes[i] = decide(&sums[(size_t)i * outputSize], outputSize, margin);
+        margins[i] = margin / (double)_small->clausePerOutput();
+    }
+}
+
+/// @brief Classes given by the large machine.
+/// @param mdata Packed samples.
+/// @return Class of each sample.
+vector<int>
+TsetlinCascade::scoreLarge(const PackedData &mdata)
+{
+    const int   outputSize = _large->outputSize();
+    vector<int> sums(mdata.size() * outputSize, 0);
+    vector<int> classes(mdata.size(), 0);
+    _large->score(mdata, sums.data());
+    for (int i = 0; i < mdata.size(); i++)
+    {
+        int margin = 0;
+        classes[i] = decide(&sums[(size_t)i * outputSize], outputSize, margin);
+    }
+    return classes;
+}
+
+/// @brief Choose the smallest threshold whose accuracy is within a given loss of the large machine.
+/// @param validation Packed samples and labels.
+/// @param maxAccuracyLoss Accuracy allowed to lose compared to the large machine alone.
+/// @return Chosen threshold and its accuracy and escalation on validation set, threshold is applied.
+TsetlinCascade::Calibration
+TsetlinCascade::calibrate(TsetlinMachine::PackedSet &validation, double maxAccuracyLoss)
+{
+    const int       sampleNum = validation.data.size();
+    vector<int>     smallClasses;
+    vector<double>  margins;
+    scoreSmall(validation.data, smallClasses, margins);
+    vector<int>     largeClasses = scoreLarge(validation.data);
+
+    vector<int> order(sampleNum, 0);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b){return margins[a] < margins[b];});
+
+    int smallCorrect = 0, largeCorrect = 0;
+    for (int i = 0; i < sampleNum; i++)
+    {
+        smallCorrect += (smallClasses[i] == validation.labels[i]);
+        largeCorrect += (largeClasses[i] == validation.labels[i]);
+    }
+    Calibration result;
+    result.largeAccuracy = largeCorrect / (double)sampleNum;
+    const double    target = result.largeAccuracy - maxAccuracyLoss;
+    int             correct = smallCorrect;     // Nothing escalated yet.
+    int             escalated = 0;
+    double          threshold = -1;             // Margins are never negative.
+    while(correct < target * sampleNum && escalated < sampleNum)
+    {
+        const double margin = margins[order[escalated]];
+        while(escalated < sampleNum && margins[order[escalated]] == margin)   // Equal margins escalate together.
+        {
+            const int i = order[escalated++];
+            correct += (largeClasses[i] == validation.labels[i]) - (smallClasses[i] == validation.labels[i]);
+        }
+        threshold = (escalated < sampleNum)? margins[order[escalated]] : std::numeric_limits<double>::infinity();
+    }
+    _threshold = threshold;
+    result.threshold = threshold;
+    result.accuracy = correct / (double)sampleNum;
+    result.escalatedFraction = escalated / (double)sampleNum;
+    return result;
+}
+
+/// @brief Classify packed samples, escalating those below threshold, and count escalations.
+/// @param mdata Packed samples.
+/// @return Class of each sample.
+vector<int>
+TsetlinCascade::classify(const PackedData &mdata)
+{
+    vector<int>     classes;
+    vector<double>  margins;
+    scoreSmall(mdata, classes, margins);
+    vector<int>     escalatedIdx;
+    for (int i = 0; i < mdata.size(); i++)
+    {
+        if(margins[i] < _threshold) escalatedIdx.push_back(i);
+    }
+    if(!escalatedIdx.empty())
+    {
+        PackedData escalatedData(escalatedIdx.size(), mdata.inputSize());
+        for (int k = 0; k < escalatedIdx.size(); k++)
+        {
+            std::copy(mdata[escalatedIdx[k]], mdata[escalatedIdx[k]] + mdata.stride(), escalatedData[k]);
+        }
+        vector<int> largeClasses = scoreLarge(escalatedData);
+        for (int k = 0; k < escalatedIdx.size(); k++)
+        {
+            classes[escalatedIdx[k]] = largeClasses[k];
+        }
+    }
+    _requestNum.fetch_add(mdata.size(), std::memory_order_relaxed);
+    _escalatedNum.fetch_add(escalatedIdx.size(), std::memory_order_relaxed);
+    return classes;
+}
+
+/// @brief Load data and predict response through the cascade.
+/// @param data 2D vector shaped in ( sampleNum * inputSize )
+/// @return 2D vector shaped in ( sampleNum * outputSize )
+vector<vector<int>>
+TsetlinCascade::loadAndPredict(vector<vector<int>> &data)
+{
+    PackedData          mdata = _small->packData(data);
+    vector<int>         classes = classify(mdata);
+    vector<vector<int>> result(data.size(), vector<int>(_small->outputSize(), 0));
+    for (int i = 0; i < data.size(); i++)
+    {
+        result[i][classes[i]] = 1;
+    }
+    return result;
+}
+
+/// @brief Fraction of requests escalated to the large machine since last reset.
+/// @return Escalated samples divided by classified samples, 0 before any request.
+double
+TsetlinCascade::escalatedFraction()const noexcept
+{
+    const long requestNum = _requestNum.load(std::memory_order_relaxed);
+    return (requestNum == 0)? 0 : _escalatedNum.load(std::memory_order_relaxed) / (double)requestNum;
+}
@@ -0,0 +1,71 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include <memory>
+#include <atomic>
+#include "TsetlinMachine.h"
+using std::vector;
+using std::string;
+
+/// @brief Serving cascade, a small machine answers confident samples and
+///        forwards samples of low vote margin to a large machine.
+///        classify may be called concurrently, calibrate and setThreshold may not.
+class TsetlinCascade{
+public:
+    struct Calibration
+    {
+        double          threshold;          // Margins below it are escalated.
+        double          accuracy;           // Accuracy of cascade on validation set.
+        double          largeAccuracy;      // Accuracy of large machine alone.
+        double          escalatedFraction;  // Fraction of validation samples escalated.
+    };
+
+private:
+    std::unique_ptr<TsetlinMachine>     _small;     // Automatas refer to their machine, never relocate.
+    std::unique_ptr<TsetlinMachine>     _large;
+    double                      _threshold;     // Infinity escalates everything, negative escalates nothing.
+    std::atomic<long>           _requestNum;    // Updated by concurrent classify calls.
+    std::atomic<long>           _escalatedNum;
+
+    void        scoreSmall( const PackedData &mdata,
+                            vector<int> &classes,
+                            vector<double> &margins);
+    vector<int> scoreLarge(const PackedData &mdata);
+
+    static int  decide(const int *sums, int outputSize, int &margin)noexcept;
+
+public:
+    TsetlinCascade( TsetlinMachine::model &smallModel,
+                    TsetlinMachine::model &largeModel);
+
+    Calibration         calibrate(TsetlinMachine::PackedSet &validation, double maxAccuracyLoss);
+    void                setThreshold(double threshold)noexcept  {_threshold = threshold;}
+    double              threshold()const noexcept               {return _threshold;}
+
+    vector<int>         classify(const PackedData &mdata);
+    vector<vector<int>> loadAndPredict(vector<vector<int>> &data);
+
+    double              escalatedFraction()const noexcept;
+    void                resetStats()noexcept                    {_requestNum = 0; _escalatedNum = 0;}
+};
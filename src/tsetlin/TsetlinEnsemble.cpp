@@ -0,0 +1,182 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#include "TsetlinEnsemble.h"
+#include <thread>
+#include <atomic>
+#include <numeric>
+#include <algorithm>
+
+TsetlinEnsemble::TsetlinEnsemble(EnsembleArgs args, vector<string> tierTags):
+_memberNum(args.memberNum),
+_threadNum(std::max(1, std::min(args.threadNum, args.memberNum))),
+_inputSize(args.machineArgs.inputSize),
+_outputSize(args.machineArgs.outputSize),
+_bootstrap(args.bootstrap),
+_numaAware(args.numaAware)
+{
+    if(args.memberNum <= 0 || !(args.featureRatio > 0 && args.featureRatio <= 1))
+    {
+        std::cout<<"Ensemble needs at least one member and a featureRatio in (0, 1]."<<std::endl;
+        throw;
+    }
+    if(args.seed != 0)
+    {
+        std::seed_seq sequence{(uint32_t)args.seed, (uint32_t)(args.seed >> 32)};  // A raw seed loses its low bits in pcg64_fast.
+        _rng.seed(sequence);
+    }
+    else
+    {
+        pcg_extras::seed_seq_from<std::random_device> seed_source;
+        _rng.seed(seed_source);
+    }
+
+    const int   visibleNum = std::max(1, (int)(args.featureRatio * _inputSize + 0.5));
+    vector<int> columns(_inputSize, 0);
+    std::iota(columns.begin(), columns.end(), 0);
+    for (int m = 0; m < _memberNum; m++)
+    {
+        TsetlinMachine::MachineArgs mArgs = args.machineArgs;
+        if(args.seed != 0) mArgs.seed = args.seed + m + 1;     // Distinct but reproducible streams.
+        _members.emplace_back(std::make_unique<TsetlinMachine>(mArgs, tierTags));
+        if(visibleNum < _inputSize)      // Feature subsampling view, data stays shared.
+        {
+            std::shuffle(columns.begin(), columns.end(), _rng);
+            _members[m]->restrictInput(vector<int>(columns.begin(), columns.begin() + visibleNum));
+        }
+    }
+    _orders.resize(_memberNum);
+}
+
+/// @brief Run job(0..jobNum-1) on a pool of _threadNum workers.
+/// @param jobNum Number of jobs.
+/// @param job Callable taking job index and worker index.
+template<typename Job>
+void
+TsetlinEnsemble::parallelFor(int jobNum, Job job)
+{
+    std::atomic<int>    next(0);
+    vector<std::thread> threadPool;
+    for (int t = 0; t < _threadNum; t++)
+    {
+        threadPool.emplace_back([&, t]()
+        {
+            if(_numaAware)
+            {
+                NumaTopology &topology = NumaTopology::instance();
+                topology.pinThread(topology.nodeOf(t, _threadNum));
+            }
+            for (int i = next++; i < jobNum; i = next++) job(i, t);
+        });
+    }
+    for (int t = 0; t < _threadNum; t++)
+    {
+        threadPool[t].join();
+    }
+}
+
+/// @brief Copy of shared data on the node of a worker.
+/// @param worker Index of worker inside parallelFor.
+/// @return Node-local replica when NUMA aware, otherwise the shared data.
+const TsetlinMachine::PackedSet&
+TsetlinEnsemble::localData(int worker)const noexcept
+{
+    if(_replicas.empty()) return _sharedData;
+    return _replicas[NumaTopology::instance().nodeOf(worker, _threadNum)];
+}
+
+/// @brief Pack data once for all members, then draw each member's view of it.
+/// @param data 2D vector shaped in ( sampleNum * inputSize )
+/// @param response 2D vector shaped in ( sampleNum * outputSize )
+void
+TsetlinEnsemble::load(  vector<vector<int>> &data,
+                        vector<vector<int>> &response)
+{
+    _sharedData = _members[0]->packSet(data, response);
+    _replicas.clear();
+    if(_numaAware && NumaTopology::instance().nodeNum() > 1)
+    {
+        _replicas = NumaTopology::instance().replicate(_sharedData);
+    }
+    const int sampleNum = data.size();
+    std::uniform_int_distribution<int> pick(0, sampleNum - 1);
+    for (int m = 0; m < _memberNum; m++)
+    {
+        _orders[m].resize(sampleNum);
+        if(_bootstrap)
+        {
+            for(auto &idx : _orders[m]) idx = pick(_rng);
+        }
+        else
+        {
+            std::iota(_orders[m].begin(), _orders[m].end(), 0);
+        }
+    }
+}
+
+/// @brief Train all members in parallel on their views of the shared dataset.
+/// @param epoch Max count of repeat training time.
+void
+TsetlinEnsemble::train(int epoch)
+{
+    parallelFor(_memberNum, [&](int m, int worker)
+    {
+        _members[m]->train(epoch, localData(worker), _orders[m]);
+    });
+}
+
+/// @brief Batched scoring, every member evaluates the whole batch.
+/// @param mdata Packed samples.
+/// @return Row-major vote sums shaped in ( sampleNum * outputSize ), summed over members.
+vector<int>
+TsetlinEnsemble::score(const PackedData &mdata)
+{
+    const size_t        matrixSize = mdata.size() * _outputSize;
+    vector<vector<int>> partial(_threadNum, vector<int>(matrixSize, 0));   // One matrix per worker, no locking.
+    parallelFor(_memberNum, [&](int m, int worker)
+    {
+        _members[m]->score(mdata, partial[worker].data());
+    });
+    for (int t = 1; t < _threadNum; t++)
+    {
+        for (size_t i = 0; i < matrixSize; i++) partial[0][i] += partial[t][i];
+    }
+    return partial[0];
+}
+
+/// @brief Load data and predict response by summed votes of all members.
+/// @param data 2D vector shaped in ( sampleNum * inputSize )
+/// @return 2D vector shaped in ( sampleNum * outputSize )
+vector<vector<int>>
+TsetlinEnsemble::loadAndPredict(vector<vector<int>> &data)
+{
+    PackedData          mdata = _members[0]->packData(data);
+    vector<int>         scores = score(mdata);
+    vector<vector<int>> result(data.size(), vector<int>(_outputSize,0));
+    for (int sampleIdx = 0; sampleIdx < data.size(); sampleIdx++)
+    {
+        int *row = &scores[(size_t)sampleIdx * _outputSize];
+        result[sampleIdx][TsetlinMachine::argmax(row, _outputSize)] = 1;     // Same rule as a single member.
+    }
+    return result;
+}
@@ -0,0 +1,72 @@
+// An implementation of Tsetlin Machine in C++ using SIMD instructions and meta-heuristic optimizers.
+
+// The MIT License (MIT)
+// Copyright (c) 2022 Pan Zhaowu <panzhaowu21s@ict.ac.cn>
+
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+
+#pragma once
+#include <memory>
+#include "TsetlinMachine.h"
+#include "NumaTopology.h"
+using std::vector;
+using std::string;
+
+/// @brief Bagging ensemble of Tsetlin machines sharing one packed dataset.
+class TsetlinEnsemble{
+public:
+    struct EnsembleArgs
+    {
+        TsetlinMachine::MachineArgs machineArgs;    // Arguments shared by all members.
+        int             memberNum;
+        int             threadNum;
+        bool            bootstrap = true;           // Each member visits a bootstrap resample of samples.
+        double          featureRatio = 1.0;         // Ratio of input columns visible to each member.
+        uint64_t        seed = 0;                   // 0 means seeded from random device.
+        bool            numaAware = false;          // Pin workers to nodes and replicate data per node.
+    };
+
+private:
+    const int                                   _memberNum;
+    const int                                   _threadNum;
+    const int                                   _inputSize;
+    const int                                   _outputSize;
+    const bool                                  _bootstrap;
+    const bool                                  _numaAware;
+    pcg64_fast                                  _rng;
+
+    vector<std::unique_ptr<TsetlinMachine>>     _members;   // Automatas refer to their machine, never relocate.
+    vector<vector<int>>                         _orders;    // Sample indices visited by each member.
+    TsetlinMachine::PackedSet                   _sharedData;
+    vector<TsetlinMachine::PackedSet>           _replicas;  // Node-local copies of _sharedData, empty on one node.
+
+    template<typename Job>
+    void    parallelFor(int jobNum, Job job);
+    const TsetlinMachine::PackedSet&    localData(int worker)const noexcept;
+
+public:
+    TsetlinEnsemble(EnsembleArgs args, vector<string> tierTags);
+
+    void                load(   vector<vector<int>> &data,
+                                vector<vector<int>> &response);
+    void                train(int epoch);
+
+    vector<int>         score(const PackedData &mdata);
+    vector<vector<int>> loadAndPredict(vector<vector<int>> &data);
+};
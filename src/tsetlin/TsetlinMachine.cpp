@@ -22,9 +22,30 @@
 //  DEALINGS IN THE SOFTWARE.
 
 #include "TsetlinMachine.h"
+#include "PackedDataset.h"
+#include "MappedDataset.h"
+#include "ModelFile.h"
+#include "Checkpointer.h"
 #include <thread>
+#include <atomic>
+#include <numeric>
+#include <algorithm>
+#include <unordered_map>
 
 TsetlinMachine::TsetlinMachine( MachineArgs args, vector<string> tierTags)noexcept:
+TsetlinMachine(args, tierTags, nullptr)
+{
+}
+
+/// @brief Serve or resume a model mapped from a binary model file, clause state is not copied.
+///        Pages are private to the mapping, so training only copies the pages it writes.
+/// @param file Mapped model file, kept alive by this machine.
+TsetlinMachine::TsetlinMachine( std::shared_ptr<ModelFile> file)noexcept:
+TsetlinMachine(file->args(), file->tierTags(), file)
+{
+}
+
+TsetlinMachine::TsetlinMachine( MachineArgs args, vector<string> tierTags, std::shared_ptr<ModelFile> file)noexcept:
 _inputSize(args.inputSize),
 _outputSize(args.outputSize),
 _clausePerOutput(args.clausePerOutput),
@@ -32,7 +53,9 @@ _T(args.T),
 _sLow(args.sLow), _sHigh(args.sHigh),
 _dropoutRatio(args.dropoutRatio),
 _myArgs(args),
-_tierTags(tierTags)
+_tierTags(tierTags),
+_sharedData(std::make_shared<PackedSet>()),
+_modelFile(file)
 {
     Automata::AutomataArgs aArgs;
     aArgs.clauseNum = _clausePerOutput;
@@ -41,16 +64,150 @@ _tierTags(tierTags)
     aArgs.sLow = _sLow;
     aArgs.sHigh = _sHigh;
     aArgs.T = _T;
+    aArgs.hugePage = args.hugePage;
+    aArgs.seed = args.seed;
 
-    _response.resize(_outputSize, vector<int>(1,0));    // Set dummy zero response as placeholder.
+    if(args.seed != 0)
+    {
+        std::seed_seq sequence{(uint32_t)args.seed, (uint32_t)(args.seed >> 32)};  // A raw seed loses its low bits in pcg64_fast.
+        _rng.seed(sequence);
+    }
+    else
+    {
+        pcg_extras::seed_seq_from<std::random_device> seed_source;
+        _rng.seed(seed_source);
+    }
+
+    _automatas.reserve(_outputSize);
     for (int i = 0; i < _outputSize; i++)
     {
         aArgs.no = i;
-        Automata thisAutomata(aArgs,_sharedData,_response[i]);
-        _automatas.push_back(thisAutomata);
+        aArgs.mapped = (file != nullptr)? file->arena(i) : nullptr;
+        _automatas.emplace_back(aArgs,_sampleOrder);
+    }
+    _streamBlocks.resize(_inputSize/16 + (_inputSize%16==0? 0:1), _mm512_setzero_si512());
+}
+
+/// @brief Rebuild a machine from saved model.
+/// @param savedModel Model exported by exportModel.
+TsetlinMachine::TsetlinMachine( model &savedModel):
+TsetlinMachine(savedModel.modelArgs, savedModel.tierTags)
+{
+    importModel(savedModel);
+}
+
+/// @brief Warm start: build a machine of new clause number or T from a trained model,
+///        learned clauses are kept and extra clauses are freshly initialized.
+/// @param savedModel Model exported by a machine of identical input and output size.
+/// @param args Arguments of the new machine.
+TsetlinMachine::TsetlinMachine( model &savedModel, MachineArgs args):
+TsetlinMachine(args, savedModel.tierTags)
+{
+    bool isCompatible = (savedModel.modelArgs.inputSize == _inputSize) &&
+                        (savedModel.modelArgs.outputSize == _outputSize) &&
+                        (savedModel.automatas.size() == _outputSize);
+    if(!isCompatible)
+    {
+        std::cout<<"Your Tsetlin Machine model failed integrity check!"<<std::endl;
+        throw;
+    }
+    for (int i = 0; i < _outputSize; i++)
+    {
+        _automatas[i].warmStart(savedModel.automatas[i]);
+    }
+}
+
+/// @brief Rebuild a machine from a snapshot, clause arenas are copied as they are.
+/// @param snapshot Snapshot taken by snapshot or share.
+TsetlinMachine::TsetlinMachine( const Snapshot &snapshot)noexcept:
+TsetlinMachine(snapshot.modelArgs, snapshot.tierTags)
+{
+    for (int i = 0; i < _outputSize; i++)
+    {
+        _automatas[i].restore(snapshot.arenas[i]);
+    }
+}
+
+/// @brief Warm start from a snapshot without unpacking it into a model.
+/// @param snapshot Snapshot of a machine of identical input and output size.
+/// @param args Arguments of the new machine.
+TsetlinMachine::TsetlinMachine( const Snapshot &snapshot, MachineArgs args):
+TsetlinMachine(args, snapshot.tierTags)
+{
+    bool isCompatible = (snapshot.modelArgs.inputSize == _inputSize) &&
+                        (snapshot.modelArgs.outputSize == _outputSize) &&
+                        (snapshot.arenas.size() == _outputSize);
+    if(!isCompatible)
+    {
+        std::cout<<"Your Tsetlin Machine model failed integrity check!"<<std::endl;
+        throw;
+    }
+    for (int i = 0; i < _outputSize; i++)
+    {
+        _automatas[i].warmStart(snapshot.arenas[i]);
     }
 }
 
+/// @brief Length of rows accepted by load and predict, wider than inputSize for pruned machines.
+int
+TsetlinMachine::rowSize()const noexcept
+{
+    return _myArgs.inputRemap.empty()? _inputSize : _myArgs.originalInputSize;
+}
+
+/// @brief Pick remapped columns of a pruned machine from one row of original width.
+/// @param row Sample of rowSize() literals.
+/// @param narrowed Scratch of _inputSize literals reused across rows.
+/// @return Row itself when not pruned, otherwise narrowed.
+template<typename T>
+const T*
+TsetlinMachine::remapRow(const T *row, vector<T> &narrowed)const noexcept
+{
+    if(_myArgs.inputRemap.empty()) return row;
+    narrowed.resize(_inputSize);
+    for (int k = 0; k < _inputSize; k++)
+    {
+        narrowed[k] = row[_myArgs.inputRemap[k]];
+    }
+    return narrowed.data();
+}
+
+/// @brief Pack rows of checked length into one slab.
+/// @param data 2D vector shaped in ( sampleNum * rowSize )
+/// @param target Destination slab, reshaped to fit.
+void
+TsetlinMachine::packRows(const vector<vector<int>> &data, PackedData &target)const
+{
+    vector<int> narrowed;
+    target.resize(data.size(), _inputSize);
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        target.packRow(i, remapRow(data[i].data(), narrowed));
+    }
+}
+
+/// @brief Pack a contiguous row-major buffer of checked length into one slab in a single pass.
+/// @param rows Byte literals shaped in ( sampleNum * rowSize )
+/// @param target Destination slab, reshaped to fit.
+void
+TsetlinMachine::packRows(std::span<const uint8_t> rows, PackedData &target)const
+{
+    vector<uint8_t> narrowed;
+    const size_t    sampleNum = rows.size() / rowSize();
+    target.resize(sampleNum, _inputSize);
+    for (size_t i = 0; i < sampleNum; i++)
+    {
+        target.packRow(i, remapRow(rows.data() + i * rowSize(), narrowed));
+    }
+}
+
+/// @brief Regenerate the permutation of sample indices, loaded data is never moved.
+void
+TsetlinMachine::shuffle()noexcept
+{
+    std::shuffle(_sampleOrder.begin(), _sampleOrder.end(), _rng);
+}
+
 
 /// @brief Check model integrity before importing
 /// @param targetModel Model that user intend to import
@@ -68,13 +225,13 @@ TsetlinMachine::modelIntegrityCheck(model &targetModel)
 /// @param response Input unknown size 2D vector.
 /// @return Result of integrity check procedure.
 bool
-TsetlinMachine::dataIntegrityCheck(const vector<vector<int>> &data)
+TsetlinMachine::dataIntegrityCheck(const vector<vector<int>> &data)const
 {
     bool isZeroSize = (data.size()==0);
     bool isCorrectLength = true;
     for (int i = 0; i < data.size(); i++)
     {
-        isCorrectLength &= (data[i].size() == _inputSize);
+        isCorrectLength &= (data[i].size() == rowSize());
         if(!isCorrectLength)break;
     }
     bool result = (!isZeroSize) && (isCorrectLength);
@@ -88,14 +245,21 @@ TsetlinMachine::dataIntegrityCheck(const vector<vector<int>> &data)
 
 /// @brief Check the integrity of argument 'response'.
 /// @param response Input unknown size 2D vector.
+/// @param sampleNum Number of samples of data.
 /// @return Result of integrity check procedure.
 bool
-TsetlinMachine::responseIntegrityCheck(const vector<vector<int>> &response)
+TsetlinMachine::responseIntegrityCheck(const vector<vector<int>> &response, size_t sampleNum)const
 {
     bool isZeroSize = (response.size()==0);
-    bool isCorrectLength = (response.size()==_outputSize);
+    bool isCorrectLength = (response.size()==sampleNum);
+    bool isOneHot = true;
+    for (int i = 0; i < response.size() && isCorrectLength && isOneHot; i++)
+    {
+        isCorrectLength &= (response[i].size() == _outputSize);
+        isOneHot &= (hotIndex(response[i]) >= 0);   // Each sample belongs to exactly one class.
+    }
 
-    bool result = (!isZeroSize) && (isCorrectLength); 
+    bool result = (!isZeroSize) && (isCorrectLength) && (isOneHot);
     if (!result)
     {
         std::cout<<"Response failed integrity check."<<std::endl;
@@ -103,25 +267,6 @@ TsetlinMachine::responseIntegrityCheck(const vector<vector<int>> &response)
     return result;
 }
 
-/// @brief Transpose response matrix before store in shared vector.
-/// @param original Original 2D vector of response, shaped in ( sampleNum * _outputSize )
-/// @return Transposed 2D vector of response , shaped in ( _outputSize * sampleNum )
-vector<vector<int>> 
-TsetlinMachine::transpose(vector<vector<int>> &original)
-{
-    int rowNum = original.size();
-    int colNum = original[0].size();
-    vector<vector<int>> result(colNum, vector<int>(rowNum,0));
-    for (int row = 0; row < rowNum; row++)
-    {
-        for (int col = 0; col < colNum; col++)
-        {
-            result[col][row] = original[row][col];
-        }
-    }
-    return result;    
-}
-
 /// @brief Pack and 'align' the original vector of int to 512Byte pack with zero-padding if size not equal to 16-mer.
 /// @param original Original vector of 32bit integer.
 /// @return Vector of packed and zero-padded __m512i pack vector.
@@ -154,7 +299,6 @@ TsetlinMachine::pack(vector<int> &original)
     return result;
 }
 
-/*
 /// @brief Import model from user.
 /// @param targetModel Target model in class of TsetlinMachine::model.
 void
@@ -170,9 +314,67 @@ TsetlinMachine::importModel(model &targetModel)
         _automatas[i].importModel(targetModel.automatas[i]);
     }
 }
-*/
 
 
+/// @brief Copy state of all automatas without unpacking any clause.
+/// @param epoch Epochs trained so far, recorded for resuming.
+/// @return Flat copy of args and clause arenas.
+TsetlinMachine::Snapshot
+TsetlinMachine::snapshot(long epoch)const
+{
+    Snapshot result;
+    result.modelArgs = _myArgs;
+    result.tierTags = _tierTags;
+    result.epoch = epoch;
+    result.arenas.reserve(_outputSize);
+    for (int i = 0; i < _outputSize; i++)
+    {
+        result.arenas.push_back(_automatas[i].state());
+    }
+    return result;
+}
+
+/// @brief Snapshot for a checkpoint, dirty blocks are handed over to it and cleared here.
+/// @param epoch Epochs trained so far.
+/// @return Flat copy whose dirty bits mark blocks changed since the previous checkpoint.
+TsetlinMachine::Snapshot
+TsetlinMachine::checkpoint(long epoch)
+{
+    Snapshot result = snapshot(epoch);
+    for (int i = 0; i < _outputSize; i++)
+    {
+        _automatas[i].state().clearDirty();
+    }
+    return result;
+}
+
+/// @brief Snapshot held by a refcounted handle, e.g. the best state found so far,
+///        passed around by pointer and unpacked by toModel only when needed.
+/// @param epoch Epochs trained so far.
+/// @return Shared immutable snapshot.
+TsetlinMachine::SnapshotHandle
+TsetlinMachine::share(long epoch)const
+{
+    return std::make_shared<const Snapshot>(snapshot(epoch));
+}
+
+/// @brief Unpack a snapshot into the nested model form, as exportModel of its machine would.
+/// @param snapshot Snapshot to convert.
+/// @return Model and arguments.
+TsetlinMachine::model
+TsetlinMachine::toModel(const Snapshot &snapshot)
+{
+    TsetlinMachine::model result;
+    result.modelArgs = snapshot.modelArgs;
+    result.tierTags = snapshot.tierTags;
+    result.automatas.reserve(snapshot.arenas.size());
+    for (const ClauseArena &arena : snapshot.arenas)
+    {
+        result.automatas.push_back(Automata::exportModel(arena));
+    }
+    return result;
+}
+
 /// @brief Export current model.
 /// @return Current model and arguments.
 TsetlinMachine::model
@@ -189,30 +391,252 @@ TsetlinMachine::exportModel()
     return result;
 }
 
-/// @brief Perform data integrity check and load into shared vector.
+/// @brief Drop input columns that no clause of any automata includes in either polarity.
+/// @return Model of a narrower machine whose clauses keep their states on remaining columns,
+///         load and predict of that machine take rows of the original width and remap them.
+TsetlinMachine::model
+TsetlinMachine::prune()
+{
+    const int           blockNum = _streamBlocks.size();
+    vector<__mmask16>   used(blockNum, 0);
+    for (int j = 0; j < _outputSize; j++)
+    {
+        const ClauseArena &arena = _automatas[j].state();
+        for (int no = 0; no < arena.clauseNum(); no++)
+        {
+            for (int b = 0; b < blockNum; b++) used[b] |= arena.posInclusion(no)[b] | arena.negInclusion(no)[b];
+        }
+    }
+    vector<int> kept;
+    for (int literal = 0; literal < _inputSize; literal++)
+    {
+        if((used[literal/16] >> (literal%16)) & 1) kept.push_back(literal);
+    }
+    if(kept.empty()) kept.push_back(0);     // Keep a valid machine even if nothing is included.
+
+    model result = exportModel();
+    result.modelArgs.inputSize = kept.size();
+    result.modelArgs.originalInputSize = rowSize();
+    result.modelArgs.inputRemap.clear();
+    for(int literal : kept)     // Compose with remap of this machine if already pruned.
+    {
+        result.modelArgs.inputRemap.push_back(_myArgs.inputRemap.empty()? literal : _myArgs.inputRemap[literal]);
+    }
+    auto narrow = [&](vector<int> &literals)
+    {
+        vector<int> narrowed(2 * kept.size(), 0);
+        for (int k = 0; k < kept.size(); k++)
+        {
+            narrowed[k] = literals[kept[k]];
+            narrowed[k + kept.size()] = literals[kept[k] + _inputSize];
+        }
+        literals.swap(narrowed);
+    };
+    for(auto &automata : result.automatas)
+    {
+        for(auto &clause : automata.positiveClauses) narrow(clause);
+        for(auto &clause : automata.negativeClauses) narrow(clause);
+    }
+    return result;
+}
+
+/// @brief Build a lean inference model: clauses never fired on loaded data are removed,
+///        identical clauses are merged into one weighted clause, unused literals are dropped.
+/// @return Compacted model predicting the same as this machine on loaded data.
+CompactMachine
+TsetlinMachine::compact()
+{
+    if(!_sharedData || _sharedData->data.size() == 0)
+    {
+        std::cout<<"Load data before compaction, clauses are kept only if they fire on loaded data."<<std::endl;
+        throw;
+    }
+    const int           blockNum = _streamBlocks.size();
+    const int           clauseNum = 2 * _clausePerOutput;
+    vector<__mmask16>   mask(blockNum, 0), inverse(blockNum, 0);
+
+    ////////// Find clauses that fire at least once on loaded data //////////
+    vector<vector<char>>    isFired(_outputSize, vector<char>(clauseNum, 0));
+    vector<vector<int>>     pending(_outputSize, vector<int>(clauseNum, 0));
+    for (int j = 0; j < _outputSize; j++)
+    {
+        std::iota(pending[j].begin(), pending[j].end(), 0);
+    }
+    const PackedData    &loaded = _sharedData->data;
+    for (int sampleIdx = 0; sampleIdx < loaded.size(); sampleIdx++)
+    {
+        _automatas[0].state().maskInput(loaded[sampleIdx], mask.data(), inverse.data());
+        for (int j = 0; j < _outputSize; j++)
+        {
+            const ClauseArena &arena = _automatas[j].state();
+            for (int k = 0; k < pending[j].size();)
+            {
+                int no = pending[j][k];
+                if(arena.evaluate(no, mask.data(), inverse.data()))
+                {
+                    isFired[j][no] = 1;
+                    pending[j][k] = pending[j].back();
+                    pending[j].pop_back();
+                }
+                else k++;
+            }
+        }
+    }
+    ////////// Find clauses that fire at least once on loaded data //////////
+
+    ////////// Merge identical include sets into weighted clauses //////////
+    std::unordered_map<string, int>     uniqueIdx;
+    vector<vector<__mmask16>>           includeSets;    // Positive masks followed by negative masks.
+    vector<vector<int>>                 weights(_outputSize);
+    for (int j = 0; j < _outputSize; j++)
+    {
+        const ClauseArena &arena = _automatas[j].state();
+        for (int no = 0; no < clauseNum; no++)
+        {
+            if(!isFired[j][no]) continue;
+            string signature(reinterpret_cast<const char*>(arena.posInclusion(no)), blockNum * sizeof(__mmask16));
+            signature.append(reinterpret_cast<const char*>(arena.negInclusion(no)), blockNum * sizeof(__mmask16));
+            auto found = uniqueIdx.find(signature);
+            int idx;
+            if(found == uniqueIdx.end())
+            {
+                idx = includeSets.size();
+                uniqueIdx.emplace(signature, idx);
+                includeSets.emplace_back(arena.posInclusion(no), arena.posInclusion(no) + blockNum);
+                includeSets.back().insert(  includeSets.back().end(),
+                                            arena.negInclusion(no), arena.negInclusion(no) + blockNum);
+                for(auto &row : weights) row.push_back(0);
+            }
+            else idx = found->second;
+            weights[j][idx] += (no < _clausePerOutput)? 1 : -1;     // Negative polarity votes against.
+        }
+    }
+    ////////// Merge identical include sets into weighted clauses //////////
+
+    ////////// Drop clauses cancelled out and literals never included //////////
+    vector<int>         kept;
+    vector<__mmask16>   used(blockNum, 0);
+    for (int idx = 0; idx < includeSets.size(); idx++)
+    {
+        bool isEffective = false;
+        for (int j = 0; j < _outputSize; j++) isEffective |= (weights[j][idx] != 0);
+        if(!isEffective) continue;
+        kept.push_back(idx);
+        const __mmask16 *masks = includeSets[idx].data();
+        for (int b = 0; b < blockNum; b++) used[b] |= masks[b] | masks[b + blockNum];
+    }
+    vector<int> newColumn(_inputSize, -1);
+    CompactMachine::CompactArgs cArgs;
+    for (int literal = 0; literal < _inputSize; literal++)
+    {
+        if((used[literal/16] >> (literal%16)) & 1)
+        {
+            newColumn[literal] = cArgs.inputRemap.size();
+            cArgs.inputRemap.push_back(_myArgs.inputRemap.empty()? literal : _myArgs.inputRemap[literal]);
+        }
+    }
+    cArgs.originalInputSize = rowSize();
+    cArgs.outputSize = _outputSize;
+    cArgs.tierTags = _tierTags;
+    cArgs.weights.resize(_outputSize);
+    for(int idx : kept)
+    {
+        const __mmask16 *masks = includeSets[idx].data();
+        vector<int> pos, neg;
+        for (int literal = 0; literal < _inputSize; literal++)
+        {
+            if((masks[literal/16] >> (literal%16)) & 1) pos.push_back(newColumn[literal]);
+            if((masks[literal/16 + blockNum] >> (literal%16)) & 1) neg.push_back(newColumn[literal]);
+        }
+        cArgs.positiveIncludes.push_back(pos);
+        cArgs.negativeIncludes.push_back(neg);
+        for (int j = 0; j < _outputSize; j++) cArgs.weights[j].push_back(weights[j][idx]);
+    }
+    ////////// Drop clauses cancelled out and literals never included //////////
+    return CompactMachine(cArgs);
+}
+
+/// @brief Perform data integrity check and load into a slab owned by this machine.
 /// @param data 2D vector shaped in ( sampleNum * _inputSize )
 /// @param response 2D vector shaped in ( sampleNum * _outputSize )
 void
 TsetlinMachine::load(vector<vector<int>> &data,
                                 vector<vector<int>> &response)
 {
-    vector<vector<int>> temp = transpose(response);
-    if( !dataIntegrityCheck(data) || 
-        !responseIntegrityCheck(temp)) {throw;return;}
-    _sharedData.resize( data.size(),
-                        vector<__m512i>(1, _mm512_set1_epi32(0)));
-    for (int i = 0; i < _outputSize; i++)
+    _sharedData = std::make_shared<PackedSet>(packSet(data, response));    // Checks integrity.
+    _sampleOrder.resize(data.size());
+    std::iota(_sampleOrder.begin(), _sampleOrder.end(), 0);
+}
+
+/// @brief Check a contiguous row-major buffer against its labels.
+/// @param valueNum Number of elements in the buffer.
+/// @param rowLength Elements per row.
+/// @param labels Class index of each row.
+/// @return Result of integrity check procedure.
+bool
+TsetlinMachine::spanIntegrityCheck(size_t valueNum, size_t rowLength, std::span<const uint8_t> labels)const
+{
+    bool isRightLength = (labels.size() > 0) && (valueNum == labels.size() * rowLength);
+    bool isRightLabel = std::all_of(labels.begin(), labels.end(), [&](uint8_t l){return l < _outputSize;});
+    bool result = isRightLength && isRightLabel;
+    if (!result)
     {
-        _response[i] = temp[i];
+        std::cout<<"Data failed integrity check."<<std::endl;
     }
+    return result;
+}
 
-    for (int i = 0; i < data.size(); i++)
+/// @brief Load a contiguous row-major buffer in one pass, no per row allocation is made.
+/// @param rows Byte literals shaped in ( sampleNum * inputSize ), original width for pruned machines.
+/// @param labels Class index of each sample.
+void
+TsetlinMachine::load(   std::span<const uint8_t> rows,
+                        std::span<const uint8_t> labels)
+{
+    _sharedData = std::make_shared<PackedSet>(packSet(rows, labels));      // Checks integrity.
+    _sampleOrder.resize(labels.size());
+    std::iota(_sampleOrder.begin(), _sampleOrder.end(), 0);
+}
+
+/// @brief Load already bit-packed rows in one pass.
+/// @param packedRows Bit-packed samples of _inputSize literals, each consumes wordsPerSample() words.
+/// @param labels Class index of each sample.
+void
+TsetlinMachine::load(   std::span<const uint64_t> packedRows,
+                        std::span<const uint8_t> labels)
+{
+    const int stride = wordsPerSample();
+    if(!spanIntegrityCheck(packedRows.size(), stride, labels)) {throw;return;}
+    auto loaded = std::make_shared<PackedSet>();
+    loaded->data.resize(labels.size(), _inputSize);
+    for (size_t i = 0; i < labels.size(); i++)
+    {
+        loaded->data.packBits(i, packedRows.data() + i * stride);
+    }
+    loaded->labels.assign(labels.begin(), labels.end());
+    _sharedData = std::move(loaded);
+    _sampleOrder.resize(labels.size());
+    std::iota(_sampleOrder.begin(), _sampleOrder.end(), 0);
+}
+
+/// @brief Train on a dataset packed once and shared, no copy of it is made.
+///        Any number of machines may load the same dataset and train concurrently.
+/// @param dataset Shared dataset, its train split becomes the loaded data.
+void
+TsetlinMachine::load(std::shared_ptr<const PackedDataset> dataset)
+{
+    bool isRightShape = (dataset != nullptr) &&
+                        (dataset->inputSize() == _inputSize) &&
+                        (rowSize() == _inputSize) &&
+                        (dataset->outputSize() <= _outputSize);
+    if(!isRightShape)
     {
-        _sharedData[i] = pack(data[i]);
+        std::cout<<"Shared dataset failed integrity check."<<std::endl;
+        throw;
     }
-    _response.shrink_to_fit();
-    _sharedData.shrink_to_fit();
-    //std::cout<<"Loaded "<<data.size()<< " samples, each consumes "<<_sharedData[0].size()<< " blocks"<<std::endl;
+    _sharedData = std::shared_ptr<const PackedSet>(dataset, &dataset->train());    // Keeps whole dataset alive.
+    _sampleOrder.resize(_sharedData->labels.size());
+    std::iota(_sampleOrder.begin(), _sampleOrder.end(), 0);
 }
 
 /// @brief Train this Tsetlin machine using loaded data.
@@ -222,48 +646,600 @@ TsetlinMachine::train(int epoch)
 {
     for (int i = 0; i < epoch; i++)
     {
+        if(_myArgs.shuffle) shuffle();          // One order per epoch, shared by all automatas.
         for (int j = 0; j < _outputSize; j++)   // Each output corresponds an automata.
         {
-            _automatas[j].learn();
+            _automatas[j].learn(_sharedData->data, _sharedData->labels);
+        }
+    }
+}
+
+/// @brief Train with periodic validation, stop when accuracy plateaus and keep the best state.
+/// @param epoch Max count of repeat training time.
+/// @param validation Pre-packed validation set.
+/// @param stopArgs Evaluation interval, patience and min-delta of early stopping.
+/// @return Best validation accuracy, machine is restored to the state achieving it.
+double
+TsetlinMachine::train(int epoch, const PackedSet &validation, StopArgs stopArgs)
+{
+    bool isValid =  (stopArgs.evalInterval > 0) && (stopArgs.patience > 0) &&
+                    (validation.data.size() > 0) &&
+                    (validation.labels.size() == validation.data.size());
+    if(!isValid)
+    {
+        std::cout<<"Your early stopping arguments or validation set failed integrity check!"<<std::endl;
+        throw;
+    }
+    vector<ClauseArena> bestState(_outputSize);
+    double              bestAccuracy = -1;
+    int                 staleCount = 0;
+    for (int i = 1; i <= epoch; i++)
+    {
+        train(1);
+        if((i % stopArgs.evalInterval != 0) && (i != epoch)) continue;
+
+        double thisAccuracy = evaluate(validation);
+        if(thisAccuracy > bestAccuracy + stopArgs.minDelta)
+        {
+            bestAccuracy = thisAccuracy;
+            staleCount = 0;
+            for (int j = 0; j < _outputSize; j++)   // In-memory snapshot, no unpacking.
+            {
+                bestState[j] = _automatas[j].state();
+            }
+        }
+        else if(++staleCount >= stopArgs.patience)
+        {
+            break;
+        }
+    }
+    for (int j = 0; j < _outputSize && bestAccuracy >= 0; j++)
+    {
+        _automatas[j].restore(bestState[j]);
+    }
+    return bestAccuracy;
+}
+
+/// @brief Train on an external packed set shared with others, no copy of it is made.
+/// @param epoch Max count of repeat training time.
+/// @param data Packed samples and labels.
+/// @param order Indices of samples to visit, may repeat (e.g. bootstrap), shuffled in place.
+void
+TsetlinMachine::train(int epoch, const PackedSet &data, vector<int> &order)
+{
+    const int sampleNum = order.size();
+    for (int e = 0; e < epoch; e++)
+    {
+        if(_myArgs.shuffle) std::shuffle(order.begin(), order.end(), _rng);
+        for (int i = 0; i < sampleNum; i++)
+        {
+            if(i + 1 < sampleNum)[[likely]]        // Hide latency of random access to next sample.
+            {
+                const __m512i *next = data.data[order[i + 1]];
+                for (int b = 0; b < data.data.stride(); b++)
+                {
+                    _mm_prefetch((const char*)&next[b], _MM_HINT_T0);
+                }
+            }
+            int idx = order[i];
+            for (int j = 0; j < _outputSize; j++)
+            {
+                _automatas[j].update(data.data[idx], (data.labels[idx] == j)? 1:0);
+            }
+        }
+    }
+}
+
+/// @brief Train out of core from a memory-mapped packed file, which is read chunk by chunk.
+///        While one chunk is learned, next one is unpacked by a reader thread into the other
+///        buffer, kernel read-ahead and explicit WILLNEED advice hide I/O behind both.
+///        Samples are shuffled within each chunk, chunks are visited in file order.
+/// @param epoch Max count of repeat training time.
+/// @param file Packed dataset mapped by MappedDataset.
+/// @param chunkSize Samples unpacked per buffer.
+void
+TsetlinMachine::train(int epoch, const MappedDataset &file, size_t chunkSize)
+{
+    bool isRightShape = (file.inputSize() == _inputSize) &&
+                        (rowSize() == _inputSize) &&
+                        (file.outputSize() <= _outputSize) &&
+                        (chunkSize > 0);
+    if(!isRightShape)
+    {
+        std::cout<<"Packed dataset failed integrity check."<<std::endl;
+        throw;
+    }
+    const size_t    sampleNum = file.size();
+    PackedSet       buffers[2];
+    vector<int>     order;
+    auto fill = [&](PackedSet &target, size_t first)
+    {
+        size_t count = std::min(chunkSize, sampleNum - first);
+        if(first + count < sampleNum)       // Read ahead of the chunk after this one.
+        {
+            file.willNeed(first + count, std::min(chunkSize, sampleNum - first - count));
+        }
+        std::span<const uint64_t> rows = file.rows(first, count);
+        std::span<const uint8_t>  labels = file.labels(first, count);
+        target.data.resize(count, _inputSize);
+        for (size_t i = 0; i < count; i++)
+        {
+            target.data.packBits(i, rows.data() + i * file.wordsPerSample());
+        }
+        target.labels.assign(labels.begin(), labels.end());
+    };
+
+    for (int e = 0; e < epoch && sampleNum > 0; e++)
+    {
+        int current = 0;
+        file.willNeed(0, std::min(chunkSize, sampleNum));
+        fill(buffers[current], 0);
+        for (size_t first = 0; first < sampleNum; first += chunkSize)
+        {
+            size_t      next = first + chunkSize;
+            std::thread reader;
+            if(next < sampleNum) reader = std::thread(fill, std::ref(buffers[current ^ 1]), next);
+
+            order.resize(buffers[current].labels.size());
+            std::iota(order.begin(), order.end(), 0);
+            train(1, buffers[current], order);
+
+            if(reader.joinable()) reader.join();
+            file.release(first, buffers[current].labels.size());
+            current ^= 1;
+        }
+    }
+}
+
+/// @brief Train with periodic checkpoints written in background while training continues.
+///        To resume, build the machine from Checkpointer::latest and pass the epoch from Checkpointer::replay.
+/// @param epoch Total epochs of the run, including those before resuming.
+/// @param checkpointer Background writer, flushed before returning.
+/// @param firstEpoch Epochs already trained, e.g. by the resumed checkpoint.
+void
+TsetlinMachine::train(int epoch, Checkpointer &checkpointer, int firstEpoch)
+{
+    for (int i = firstEpoch + 1; i <= epoch; i++)
+    {
+        train(1);
+        if((i % checkpointer.interval() == 0) || (i == epoch))
+        {
+            checkpointer.submit(checkpoint(i));
+        }
+    }
+    checkpointer.flush();
+}
+
+/// @brief Learn a batch of new samples immediately, loaded dataset is left untouched.
+/// @param packedSamples Bit-packed samples, each consumes wordsPerSample() words.
+/// @param labels Class index of each sample.
+void
+TsetlinMachine::partialFit( std::span<const uint64_t> packedSamples,
+                            std::span<const uint8_t> labels)
+{
+    const int stride = wordsPerSample();
+    if(packedSamples.size() != labels.size() * stride)
+    {
+        std::cout<<"Streaming samples failed integrity check."<<std::endl;
+        throw;
+    }
+    for (int i = 0; i < labels.size(); i++)
+    {
+        update(packedSamples.subspan(i * stride, stride), labels[i]);
+    }
+}
+
+/// @brief Learn a single new sample immediately.
+/// @param packedSample Bit-packed sample of wordsPerSample() words.
+/// @param label Class index of this sample.
+void
+TsetlinMachine::update(std::span<const uint64_t> packedSample, uint8_t label)
+{
+    if((packedSample.size() != wordsPerSample()) || (label >= _outputSize))
+    {
+        std::cout<<"Streaming sample failed integrity check."<<std::endl;
+        throw;
+    }
+    PackedData::unpackBits(packedSample.data(), _inputSize, _streamBlocks.data());
+    for (int j = 0; j < _outputSize; j++)
+    {
+        _automatas[j].update(_streamBlocks.data(), (label == j)? 1:0);
+    }
+}
+
+/// @brief Learn one sample given by input masks, shared among machines of same input size.
+/// @param in Input masks computed by maskInput.
+/// @param inInverse Complement of input masks within valid literals.
+/// @param label Class index of this sample.
+void
+TsetlinMachine::update(const __mmask16 *in, const __mmask16 *inInverse, int label)noexcept
+{
+    for (int j = 0; j < _outputSize; j++)
+    {
+        _automatas[j].update(in, inInverse, (label == j)? 1:0);
+    }
+}
+
+/// @brief Convert one packed sample into input masks accepted by update.
+/// @param in Packed sample.
+/// @param mask Output mask of literals that equal to one.
+/// @param inverse Output mask of valid literals that equal to zero.
+void
+TsetlinMachine::maskInput(const __m512i *in, __mmask16 *mask, __mmask16 *inverse)const noexcept
+{
+    _automatas[0].state().maskInput(in, mask, inverse);
+}
+
+/// @brief Pack data and response once so that they can be evaluated repeatedly.
+/// @param data 2D vector shaped in ( sampleNum * _inputSize )
+/// @param response 2D vector shaped in ( sampleNum * _outputSize )
+/// @return Packed data and class index of each sample.
+TsetlinMachine::PackedSet
+TsetlinMachine::packSet(vector<vector<int>> &data,
+                        vector<vector<int>> &response)const
+{
+    if( !dataIntegrityCheck(data) || 
+        !responseIntegrityCheck(response, data.size())) {throw;}
+    PackedSet result;
+    packRows(data, result.data);
+    result.labels.resize(data.size());
+    for (int i = 0; i < data.size(); i++)
+    {
+        result.labels[i] = hotIndex(response[i]);
+    }
+    return result;
+}
+
+/// @brief Class index of a one-hot response row.
+/// @param oneHot Response row of 0 and a single 1.
+/// @return Index of the hot digit, -1 when the row is not exactly one-hot.
+int
+TsetlinMachine::hotIndex(const vector<int> &oneHot)noexcept
+{
+    int index = -1;
+    for (int j = 0; j < oneHot.size(); j++)
+    {
+        if(oneHot[j] == 0) continue;
+        if(oneHot[j] != 1 || index >= 0) return -1;
+        index = j;
+    }
+    return index;
+}
+
+/// @brief Pack a contiguous row-major buffer and its labels in one pass.
+/// @param rows Byte literals shaped in ( sampleNum * inputSize ), original width for pruned machines.
+/// @param labels Class index of each sample.
+/// @return Packed data and class index of each sample.
+TsetlinMachine::PackedSet
+TsetlinMachine::packSet(std::span<const uint8_t> rows,
+                        std::span<const uint8_t> labels)const
+{
+    if(!spanIntegrityCheck(rows.size(), rowSize(), labels)) {throw;}
+    PackedSet result;
+    packRows(rows, result.data);
+    result.labels.assign(labels.begin(), labels.end());
+    return result;
+}
+
+/// @brief Pack samples without labels, e.g. for scoring.
+/// @param data 2D vector shaped in ( sampleNum * _inputSize )
+/// @return Packed samples.
+PackedData
+TsetlinMachine::packData(vector<vector<int>> &data)const
+{
+    if( !dataIntegrityCheck(data)) throw;
+    PackedData result;
+    packRows(data, result);
+    return result;
+}
+
+/// @brief Evaluate accuracy on a packed set.
+/// @param validation Pre-packed data and labels.
+/// @return Ratio of correctly classified samples.
+double
+TsetlinMachine::evaluate(const PackedSet &validation)const
+{
+    vector<int> predicted = classify(validation.data);
+    int totalCorrect = 0;
+    for (int i = 0; i < predicted.size(); i++)
+    {
+        totalCorrect += (predicted[i] == validation.labels[i]);
+    }
+    return totalCorrect / (double)predicted.size();
+}
+
+/// @brief Accumulate vote sums of every automata into a score matrix.
+/// @param mdata Packed samples.
+/// @param scores Row-major matrix shaped in ( sampleNum * _outputSize ), added in place.
+void
+TsetlinMachine::score(const PackedData &mdata, int *scores)const
+{
+    for (int j = 0; j < _outputSize; j++)
+    {
+        vector<Automata::Prediction> prediction = _automatas[j].predict(mdata);
+        for (int sampleIdx = 0; sampleIdx < mdata.size(); sampleIdx++)
+        {
+            scores[(size_t)sampleIdx * _outputSize + j] += prediction[sampleIdx].voteSum;
+        }
+    }
+}
+
+/// @brief Only allow clauses to include literals of given input columns.
+/// @param columns Indices of visible input columns.
+void
+TsetlinMachine::restrictInput(const vector<int> &columns)
+{
+    vector<__mmask16> mask(_streamBlocks.size(), 0);
+    for(int column : columns)
+    {
+        mask[column/16] |= (1 << (column%16));
+    }
+    for (int j = 0; j < _outputSize; j++)
+    {
+        _automatas[j].restrictLiterals(mask);
+    }
+}
+
+/// @brief Vote sums of every automata on a tile of samples. The tile is masked once, then
+///        scored class by class so that clauses of one automata stay in cache across the tile.
+/// @param data Packed samples.
+/// @param first Index of first sample of the tile.
+/// @param count Samples in the tile.
+/// @param scores Row-major output shaped in ( count * _outputSize ).
+/// @param masks Scratch of ( 2 * count * blockNum ) masks.
+void
+TsetlinMachine::scoreTile(  const PackedData &data,
+                            size_t first, size_t count,
+                            int *scores, __mmask16 *masks)const noexcept
+{
+    const int   blockNum = _streamBlocks.size();
+    __mmask16   *inverses = masks + count * blockNum;
+    for (size_t i = 0; i < count; i++)
+    {
+        maskInput(data[first + i], masks + i * blockNum, inverses + i * blockNum);
+    }
+    for (int j = 0; j < _outputSize; j++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            scores[i * _outputSize + j] = _automatas[j].vote(masks + i * blockNum, inverses + i * blockNum);
+        }
+    }
+}
+
+/// @brief Winning class of this machine's vote sums.
+/// @param sums Vote sum of each class.
+/// @return Index of winning class.
+int
+TsetlinMachine::argmax(const int *sums)const noexcept
+{
+    return argmax(sums, _outputSize);
+}
+
+/// @brief Class 0 wins unless another sum is positive, ties go to the lower index.
+///        Shared by every classifier built on summed votes, e.g. ensembles.
+/// @param sums Vote sum of each class.
+/// @param outputSize Number of classes.
+/// @return Index of winning class.
+int
+TsetlinMachine::argmax(const int *sums, int outputSize)noexcept
+{
+    int competitorIdx = 0, maxSum = 0;
+    for (int j = 0; j < outputSize; j++)
+    {
+        if(sums[j] > maxSum)
+        {
+            competitorIdx = j;
+            maxSum = sums[j];
+        }
+    }
+    return competitorIdx;
+}
+
+/// @brief Predict class index of packed samples.
+/// @param mdata Packed samples.
+/// @return Index of winning automata of each sample.
+vector<int>
+TsetlinMachine::classify(const PackedData &mdata)const
+{
+    const size_t        tileSize = BatchArgs().tileSize;
+    vector<int>         result(mdata.size(), 0);
+    vector<int>         sums(tileSize * _outputSize);
+    vector<__mmask16>   masks(2 * tileSize * _streamBlocks.size());
+    for (size_t first = 0; first < mdata.size(); first += tileSize)
+    {
+        size_t count = std::min(tileSize, mdata.size() - first);
+        scoreTile(mdata, first, count, sums.data(), masks.data());
+        for (size_t i = 0; i < count; i++)
+        {
+            result[first + i] = argmax(&sums[i * _outputSize]);
         }
     }
+    return result;
 }
 
 /// @brief Load data and predict response using trained tsetlin machine.
 /// @param data 2D vector shaped in ( sampleNum * _inputSize )
 /// @return 2D vector shaped in ( sampleNum * _outputSize )
 vector<vector<int>>
-TsetlinMachine::loadAndPredict(vector<vector<int>> &data)
+TsetlinMachine::loadAndPredict(vector<vector<int>> &data)const
 {
     if( !dataIntegrityCheck(data)) throw;
-    vector<vector<Automata::Prediction>> prediction(_outputSize,
-                                                    vector<Automata::Prediction>(data.size(),Automata::Prediction()));
-    vector<vector<__m512i>> mdata;
-    mdata.resize( data.size(),
-                        vector<__m512i>(1, _mm512_set1_epi32(0)));
-    for (int i = 0; i < data.size(); i++)
+    PackedData          mdata;
+    packRows(data, mdata);
+
+    vector<int>         competitors = classify(mdata);
+    vector<vector<int>> result(data.size(), vector<int>(_outputSize,0));
+    for (int sampleIdx = 0; sampleIdx < data.size(); sampleIdx++)
     {
-        mdata[i] = pack(data[i]);
+        result[sampleIdx][competitors[sampleIdx]] = 1;
     }
+    return result;
+}
+/// @brief Decide class of one sample by refining per class bounds on vote sums chunk by chunk.
+///        Follows the rule of classify: class 0 wins unless another sum is positive, ties go to lower index.
+/// @param in Input masks of the sample.
+/// @param inInverse Complement of input masks within valid literals.
+/// @param args Chunk size, clause budget and deadline.
+/// @param evaluated Output count of evaluated clauses.
+/// @return Index of the winning class, or of the current leader when budget or deadline is hit.
+int
+TsetlinMachine::decide( const __mmask16 *in,
+                        const __mmask16 *inInverse,
+                        const EarlyExitArgs &args,
+                        long &evaluated)const noexcept
+{
+    using clock = std::chrono::steady_clock;
+    const auto      start = (args.deadline.count() > 0)? clock::now() : clock::time_point();
+    const int       chunkSize = std::max(1, args.chunkSize);
+    vector<int>     partial(_outputSize, 0);
+    vector<int>     done(_outputSize, 0);           // Clause pairs evaluated of each class.
+    vector<char>    contending(_outputSize, 1);
+    auto score = [&](int j, int sum){return (j == 0)? std::max(sum, 0) : sum;};
+    auto lower = [&](int j){return score(j, partial[j] - (_clausePerOutput - done[j]));};
+    auto upper = [&](int j){return score(j, partial[j] + (_clausePerOutput - done[j]));};
+    auto beats = [](int a, int ia, int b, int ib){return (a > b) || (a == b && ia < ib);};
 
-    for (int i = 0; i < _outputSize; i++)
+    evaluated = 0;
+    while(true)
     {
-        prediction[i] = _automatas[i].predict(mdata);
+        int leader = -1;
+        for (int j = 0; j < _outputSize; j++)
+        {
+            if(!contending[j]) continue;
+            if(leader < 0 || beats(score(j, partial[j]), j, score(leader, partial[leader]), leader)) leader = j;
+        }
+        bool isDecided = true;
+        for (int j = 0; j < _outputSize; j++)   // Bounds only tighten, so a class left behind never comes back.
+        {
+            if(j == leader || !contending[j]) continue;
+            if(beats(lower(leader), leader, upper(j), j))   contending[j] = 0;
+            else                                            isDecided = false;
+        }
+        if(isDecided) return leader;
+        if(args.clauseBudget > 0 && evaluated >= args.clauseBudget) return leader;
+        if(args.deadline.count() > 0 && clock::now() - start >= args.deadline) return leader;
+
+        for (int j = 0; j < _outputSize; j++)
+        {
+            if(!contending[j]) continue;
+            const int last = std::min(done[j] + chunkSize, _clausePerOutput);
+            partial[j] += _automatas[j].partialVote(done[j], last, in, inInverse);
+            evaluated += 2 * (last - done[j]);
+            done[j] = last;
+        }
     }
+}
+
+/// @brief Predict class of one packed sample with early exit.
+/// @param sample Packed sample.
+/// @param args Chunk size, clause budget and deadline.
+/// @param evaluatedClauses Optional output count of evaluated clauses.
+/// @return Index of predicted class.
+int
+TsetlinMachine::predict(const __m512i *sample, EarlyExitArgs args, long *evaluatedClauses)const
+{
+    vector<__mmask16>   mask(_streamBlocks.size(), 0);
+    vector<__mmask16>   inverse(_streamBlocks.size(), 0);
+    long                evaluated = 0;
+    maskInput(sample, mask.data(), inverse.data());
+    int result = decide(mask.data(), inverse.data(), args, evaluated);
+    if(evaluatedClauses) *evaluatedClauses = evaluated;
+    return result;
+}
+
+/// @brief Load data and predict response, deciding each sample as soon as its class can no longer change.
+/// @param data 2D vector shaped in ( sampleNum * _inputSize )
+/// @param args Chunk size, and per sample clause budget and deadline.
+/// @return 2D vector shaped in ( sampleNum * _outputSize )
+vector<vector<int>>
+TsetlinMachine::loadAndPredict(vector<vector<int>> &data, EarlyExitArgs args)const
+{
+    if( !dataIntegrityCheck(data)) throw;
     vector<vector<int>> result(data.size(), vector<int>(_outputSize,0));
+    vector<__mmask16>   mask(_streamBlocks.size(), 0);
+    vector<__mmask16>   inverse(_streamBlocks.size(), 0);
+    vector<int>         narrowed;
+    PackedData          packed(1, _inputSize);
+    long                evaluated = 0;
     for (int sampleIdx = 0; sampleIdx < data.size(); sampleIdx++)
     {
-        double  maxConfidence = 0;
-        int     competitorIdx = 0;
-        for (int featureIdx = 0; featureIdx < _outputSize; featureIdx++)
+        packed.packRow(0, remapRow(data[sampleIdx].data(), narrowed));
+        maskInput(packed[0], mask.data(), inverse.data());
+        result[sampleIdx][decide(mask.data(), inverse.data(), args, evaluated)] = 1;
+    }
+    return result;
+}
+
+/// @brief Predict class index of a contiguous row-major buffer.
+/// @param rows Byte literals shaped in ( sampleNum * inputSize ), original width for pruned machines.
+/// @return Class index of each sample.
+vector<int>
+TsetlinMachine::predict(std::span<const uint8_t> rows)const
+{
+    if(rows.empty() || (rows.size() % rowSize() != 0))
+    {
+        std::cout<<"Data failed integrity check."<<std::endl;
+        throw;
+    }
+    PackedData mdata;
+    packRows(rows, mdata);
+    return classify(mdata);
+}
+
+/// @brief Predict a large contiguous batch in parallel, writing straight into caller arrays.
+///        Workers claim tiles of samples, pack and score each tile in reused scratch,
+///        no per sample allocation is made and the model is only read.
+/// @param rows Byte literals shaped in ( sampleNum * inputSize ), original width for pruned machines.
+/// @param classes Output class index of each sample, sized sampleNum.
+/// @param scores Optional output vote sums shaped in ( sampleNum * outputSize ), may be empty.
+/// @param args Worker number and tile size.
+void
+TsetlinMachine::predict(std::span<const uint8_t> rows,
+                        std::span<int> classes,
+                        std::span<int> scores,
+                        BatchArgs args)const
+{
+    const size_t sampleNum = rows.size() / rowSize();
+    bool isRightLength =    (!rows.empty()) && (rows.size() % rowSize() == 0) &&
+                            (classes.size() == sampleNum) &&
+                            (scores.empty() || scores.size() == sampleNum * _outputSize) &&
+                            (args.tileSize > 0) && (args.threadNum > 0);
+    if(!isRightLength)
+    {
+        std::cout<<"Data failed integrity check."<<std::endl;
+        throw;
+    }
+    const size_t        tileSize = args.tileSize;
+    const size_t        tileNum = (sampleNum + tileSize - 1) / tileSize;
+    std::atomic<size_t> nextTile(0);
+    auto worker = [&]()
+    {
+        PackedData          tile(tileSize, _inputSize);
+        vector<int>         sums(scores.empty()? tileSize * _outputSize : 0);
+        vector<__mmask16>   masks(2 * tileSize * _streamBlocks.size());
+        vector<uint8_t>     narrowed;
+        for (size_t t = nextTile++; t < tileNum; t = nextTile++)
         {
-            if(prediction[featureIdx][sampleIdx].confidence > maxConfidence)
+            const size_t first = t * tileSize;
+            const size_t count = std::min(tileSize, sampleNum - first);
+            for (size_t i = 0; i < count; i++)
             {
-                competitorIdx = featureIdx;
-                maxConfidence = prediction[featureIdx][sampleIdx].confidence;
+                tile.packRow(i, remapRow(rows.data() + (first + i) * rowSize(), narrowed));
+            }
+            int *tileScores = scores.empty()? sums.data() : scores.data() + first * _outputSize;
+            scoreTile(tile, 0, count, tileScores, masks.data());
+            for (size_t i = 0; i < count; i++)
+            {
+                classes[first + i] = argmax(tileScores + i * _outputSize);
             }
         }
-        result[sampleIdx][competitorIdx] = 1;
+    };
+    vector<std::thread> threadPool;
+    for (int t = 1; t < std::min<size_t>(args.threadNum, tileNum); t++)
+    {
+        threadPool.emplace_back(worker);
     }
-    return result;
-}
\ No newline at end of file
+    worker();
+    for(auto &th : threadPool) th.join();
+}
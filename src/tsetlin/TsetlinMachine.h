@@ -22,10 +22,18 @@
 //  DEALINGS IN THE SOFTWARE.
 
 #pragma once
+#include <span>
+#include <memory>
 #include "Automata.h"
+#include "CompactMachine.h"
 using std::vector;
 using std::string;
 
+class PackedDataset;
+class MappedDataset;
+class ModelFile;
+class Checkpointer;
+
 // TODO: Add boost::serialization to export full model
 class TsetlinMachine{
 public:
@@ -38,18 +46,55 @@ public:
         double          sLow, sHigh;
         double          dropoutRatio;
         vector<string>  tierTags;
+        bool            shuffle = true;     // Visit samples in a fresh random order every epoch.
+        uint64_t        seed = 0;           // Seed of shuffling and feedback streams, 0 means seeded from random device.
+        bool            hugePage = false;   // Back clause arenas with transparent huge pages.
+        vector<int>     inputRemap;         // Original columns read by a pruned machine, empty means all columns.
+        int             originalInputSize = 0;  // Row length of data fed to a pruned machine.
 
-        bool operator==(MachineArgs a)const
+        bool operator==(MachineArgs a)const     // Shape of a model, runtime knobs like shuffle, seed and hugePage are ignored.
         {
-            return  (a.clausePerOutput = this->clausePerOutput) &&
-                    (a.dropoutRatio = this->dropoutRatio) &&
-                    (a.inputSize = this->inputSize) &&
-                    (a.outputSize = this->outputSize)&&
-                    (a.sHigh = this->sHigh)&&
-                    (a.sLow = this->sLow) &&
-                    (a.T = this->T);
+            return  (a.clausePerOutput == this->clausePerOutput) &&
+                    (a.dropoutRatio == this->dropoutRatio) &&
+                    (a.inputSize == this->inputSize) &&
+                    (a.outputSize == this->outputSize)&&
+                    (a.sHigh == this->sHigh)&&
+                    (a.sLow == this->sLow) &&
+                    (a.T == this->T) &&
+                    (a.inputRemap == this->inputRemap) &&
+                    (a.originalInputSize == this->originalInputSize);
         }
     };
+    struct PackedSet        // Data packed once and reused, e.g. validation set of early stopping.
+    {
+        PackedData              data;
+        vector<int>             labels;     // Index of hot digit of each response.
+    };
+    struct StopArgs
+    {
+        int             evalInterval = 1;   // Evaluate validation set every evalInterval epochs.
+        int             patience = 5;       // Stop after this many evaluations without improvement.
+        double          minDelta = 0;       // Smallest accuracy gain counted as improvement.
+    };
+    struct EarlyExitArgs
+    {
+        int                         chunkSize = 16;     // Clause pairs evaluated per contending class each round.
+        long                        clauseBudget = 0;   // Clauses evaluated per sample before answering anyway, 0 means unlimited.
+        std::chrono::nanoseconds    deadline{0};        // Time per sample before answering anyway, 0 means unlimited.
+    };
+    struct BatchArgs
+    {
+        int             threadNum = 1;      // Workers scoring tiles, the calling thread is one of them.
+        int             tileSize = 256;     // Samples packed and scored together, sized to stay in L2.
+    };
+    struct Snapshot         // Flat copy of every clause arena, taken in O(memcpy).
+    {
+        MachineArgs             modelArgs;
+        vector<string>          tierTags;
+        vector<ClauseArena>     arenas;
+        long                    epoch = 0;
+    };
+    using SnapshotHandle = std::shared_ptr<const Snapshot>;    // Immutable once taken, copies share one buffer.
     struct model
     {
         MachineArgs             modelArgs;
@@ -70,29 +115,100 @@ private:
 
     vector<Automata>            _automatas;
     
-    vector<vector<__m512i>>     _sharedData;
-    
-    vector<vector<int>>         _response;      // Each row is a reflection of multi-dimensional dataset.
+    std::shared_ptr<const PackedSet>    _sharedData;    // Loaded samples, possibly shared with other machines.
+    std::shared_ptr<ModelFile>          _modelFile;     // Mapping that clause arenas borrow their state from.
+    vector<int>                 _sampleOrder;   // Permutation of sample indices shared by all automatas.
+    pcg64_fast                  _rng;
+    vector<__m512i>             _streamBlocks;  // Unpacked block of streaming sample.
+
+    void    shuffle()noexcept;
 
     bool    modelIntegrityCheck(model &targetModel);
-    bool    dataIntegrityCheck( const vector<vector<int>> &data);
-    bool    responseIntegrityCheck(const vector<vector<int>> &response);
+    bool    dataIntegrityCheck( const vector<vector<int>> &data)const;
+    bool    responseIntegrityCheck(const vector<vector<int>> &response, size_t sampleNum)const;
+    bool    spanIntegrityCheck(size_t valueNum, size_t rowLength, std::span<const uint8_t> labels)const;
 
-    vector<vector<int>> transpose(vector<vector<int>> &original);
-    
-    
-    vector<__m512i>     pack(vector<int> &original);
+    int                 rowSize()const noexcept;
+    template<typename T>
+    const T*            remapRow(const T *row, vector<T> &narrowed)const noexcept;
+    void                packRows(const vector<vector<int>> &data, PackedData &target)const;
+    void                packRows(std::span<const uint8_t> rows, PackedData &target)const;
+    vector<int>         classify(const PackedData &mdata)const;
+    void                scoreTile(  const PackedData &data,
+                                    size_t first, size_t count,
+                                    int *scores, __mmask16 *masks)const noexcept;
+    int                 argmax(const int *sums)const noexcept;
+    int                 decide( const __mmask16 *in,
+                                const __mmask16 *inInverse,
+                                const EarlyExitArgs &args,
+                                long &evaluated)const noexcept;
+
+    TsetlinMachine( MachineArgs args, vector<string> tierTags, std::shared_ptr<ModelFile> file)noexcept;
 
 public:
     TsetlinMachine( MachineArgs args, vector<string> tierTags)noexcept;
-    //TsetlinMachine( model &savedModel)noexcept;
+    TsetlinMachine( std::shared_ptr<ModelFile> file)noexcept;
+    TsetlinMachine( model &savedModel);
+    TsetlinMachine( model &savedModel, MachineArgs args);
+    TsetlinMachine( const Snapshot &snapshot)noexcept;
+    TsetlinMachine( const Snapshot &snapshot, MachineArgs args);
 
     void                load(   vector<vector<int>> &data,
                                 vector<vector<int>> &response);
+    void                load(   std::span<const uint8_t> rows,
+                                std::span<const uint8_t> labels);
+    void                load(   std::span<const uint64_t> packedRows,
+                                std::span<const uint8_t> labels);
+    void                load(std::shared_ptr<const PackedDataset> dataset);
     void                train(int epoch);
+    double              train(int epoch, const PackedSet &validation, StopArgs stopArgs);
+    void                train(int epoch, const PackedSet &data, vector<int> &order);
+    void                train(int epoch, const MappedDataset &file, size_t chunkSize = 1<<16);
+    void                train(int epoch, Checkpointer &checkpointer, int firstEpoch = 0);
+
+    void                partialFit( std::span<const uint64_t> packedSamples,
+                                    std::span<const uint8_t> labels);
+    void                update(std::span<const uint64_t> packedSample, uint8_t label);
+    void                update(const __mmask16 *in, const __mmask16 *inInverse, int label)noexcept;
+    void                maskInput(const __m512i *in, __mmask16 *mask, __mmask16 *inverse)const noexcept;
+    int                 wordsPerSample()const noexcept {return _inputSize/64 + (_inputSize%64==0? 0:1);}
+    int                 inputSize()const noexcept       {return _inputSize;}
+    int                 outputSize()const noexcept      {return _outputSize;}
+    int                 clausePerOutput()const noexcept {return _clausePerOutput;}
+    const MachineArgs&      args()const noexcept            {return _myArgs;}
+    const vector<string>&   tierTags()const noexcept        {return _tierTags;}
+    const vector<int>&      sampleOrder()const noexcept     {return _sampleOrder;}
+    const ClauseArena&      state(int output)const noexcept {return _automatas[output].state();}
+    ClauseArena&            state(int output)noexcept       {return _automatas[output].state();}
     
-    vector<vector<int>> loadAndPredict(vector<vector<int>> &data);
+    PackedSet           packSet(vector<vector<int>> &data,
+                                vector<vector<int>> &response)const;
+    PackedSet           packSet(std::span<const uint8_t> rows,
+                                std::span<const uint8_t> labels)const;
+    PackedData          packData(vector<vector<int>> &data)const;
+    double              evaluate(const PackedSet &validation)const;
+    void                score(const PackedData &mdata, int *scores)const;
+    void                restrictInput(const vector<int> &columns);
 
-    //void                importModel(model &targetModel);
+    vector<vector<int>> loadAndPredict(vector<vector<int>> &data)const;
+    vector<vector<int>> loadAndPredict(vector<vector<int>> &data, EarlyExitArgs args)const;
+    vector<int>         predict(std::span<const uint8_t> rows)const;
+    void                predict(std::span<const uint8_t> rows,
+                                std::span<int> classes,
+                                std::span<int> scores,
+                                BatchArgs args)const;
+    int                 predict(const __m512i *sample, EarlyExitArgs args, long *evaluatedClauses = nullptr)const;
+
+    void                importModel(model &targetModel);
+    Snapshot            snapshot(long epoch = 0)const;
+    Snapshot            checkpoint(long epoch);
+    SnapshotHandle      share(long epoch = 0)const;
     model               exportModel();
+    CompactMachine      compact();
+    model               prune();
+
+    static vector<__m512i>  pack(vector<int> &original);
+    static model            toModel(const Snapshot &snapshot);
+    static int              argmax(const int *sums, int outputSize)noexcept;
+    static int              hotIndex(const vector<int> &oneHot)noexcept;
 };
\ No newline at end of file
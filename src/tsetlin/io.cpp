@@ -22,6 +22,7 @@
 //  DEALINGS IN THE SOFTWARE.
 
 #include "io.h"
+#include "ModelFile.h"
 using std::vector;
 using std::string;
 
@@ -62,22 +63,23 @@ vector<string> threshold2Tags(vector<double> thresholds, bool isAscent)
     return tags;
 }
 
-/// @brief Save Tsetlin machine model in binary format.
+/// @brief Save Tsetlin machine model in versioned binary format of ModelFile.
 /// @param machine Target model.
 /// @param outputPath Path of output file.
 void saveModel( TsetlinMachine::model   &machine,
                 string                  outputPath)
 {
-    write_binary<TsetlinMachine::model>(&machine,1,outputPath);
+    TsetlinMachine restored(machine);
+    ModelFile::write(outputPath, restored);
 }
 
 /// @brief Load Tsetlin machine model from binary model file.
+///        Serving should rather build TsetlinMachine from ModelFile::open directly, which copies nothing.
 /// @param modelPath Path of model file.
 /// @return A structured model of Tsetlin machine.
 TsetlinMachine::model loadModel(string modelPath)
 {
-    TsetlinMachine::model result;
-    read_binary<TsetlinMachine::model>(modelPath, &result);
-    return result;
+    TsetlinMachine mapped(ModelFile::open(modelPath));
+    return mapped.exportModel();
 }
 
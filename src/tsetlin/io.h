@@ -56,6 +56,8 @@ struct dataset
     vector<vector<int>>     trainResponse;
     vector<vector<int>>     testData;
     vector<vector<int>>     testResponse;
+    vector<double>          trainValue;     // Continuous responses before discretization.
+    vector<double>          testValue;
     dataset(){}
 };
 
@@ -125,7 +127,7 @@ bool write_csv( vector<vector<double>> &data,
 // TODO: Output model in binary and load in binary, also implement a transform function to csv.
 //       output all clause 
 vector<string> threshold2Tags(vector<double> thresholds, bool isAscent);
-// Model IO(deprecated)
+// Model IO in versioned binary format, see ModelFile.
 void saveModel( TsetlinMachine::model   &mahchine,
                 string                  outputPath);
 